@@ -0,0 +1,344 @@
+// Throughput benchmarks of vlite against equivalent raw-pointer loops.
+//
+//   ./bench_suite [--format=text|csv|json] [--repeats=N] [--size=N] [--filter=NAME]
+//
+// Every workload is timed `repeats` times after a warm-up run, and reported with the
+// minimum, median, mean and standard deviation of the runs.  Throughput figures use the
+// median: nanoseconds per element, and gigabytes per second of the bytes the workload
+// logically reads and writes.
+
+#include "vlite/vector.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+template <typename T> auto do_not_optimize(const T& value) -> void
+{
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r"(&value) : "memory");
+#else
+  static volatile const void* sink;
+  sink = &value;
+#endif
+}
+
+struct workload
+{
+  std::string name;
+  std::string implementation;
+  std::size_t elements;
+  std::size_t bytes;
+  std::function<void()> run;
+};
+
+struct statistics
+{
+  double min;
+  double median;
+  double mean;
+  double stddev;
+};
+
+struct result
+{
+  const workload* source;
+  statistics ns;
+};
+
+struct options
+{
+  std::string format = "text";
+  std::size_t repeats = 20u;
+  std::size_t size = std::size_t{1u} << 20;
+  std::string filter;
+};
+
+[[noreturn]] auto usage(const char* program) -> void
+{
+  std::fprintf(stderr, "usage: %s [--format=text|csv|json] [--repeats=N] [--size=N] "
+                       "[--filter=NAME]\n",
+               program);
+  std::exit(2);
+}
+
+// Parses `text` as a count of decimal digits only, or exits with the usage.
+auto parse_count(const std::string& text, const char* program) -> std::size_t
+{
+  if (text.find_first_not_of("0123456789") != std::string::npos)
+    usage(program);
+
+  try
+  {
+    return std::stoul(text);
+  }
+  catch (const std::out_of_range&)
+  {
+    usage(program);
+  }
+}
+
+auto parse_options(int argc, char** argv) -> options
+{
+  auto result = options{};
+
+  for (auto i = 1; i < argc; ++i)
+  {
+    const auto arg = std::string{argv[i]};
+    const auto value = [&](const char* prefix) {
+      const auto n = std::strlen(prefix);
+      return arg.compare(0u, n, prefix) == 0 ? arg.substr(n) : std::string{};
+    };
+
+    if (!value("--format=").empty())
+      result.format = value("--format=");
+    else if (!value("--repeats=").empty())
+      result.repeats = parse_count(value("--repeats="), argv[0]);
+    else if (!value("--size=").empty())
+      result.size = parse_count(value("--size="), argv[0]);
+    else if (!value("--filter=").empty())
+      result.filter = value("--filter=");
+    else
+      usage(argv[0]);
+  }
+
+  if (result.format != "text" && result.format != "csv" && result.format != "json")
+  {
+    std::fprintf(stderr, "unknown format: %s\n", result.format.c_str());
+    std::exit(2);
+  }
+
+  result.repeats = std::max<std::size_t>(result.repeats, 1u);
+  result.size = std::max<std::size_t>(result.size, 16u);
+  return result;
+}
+
+auto measure(const workload& w, std::size_t repeats) -> statistics
+{
+  using clock = std::chrono::steady_clock;
+
+  w.run();
+
+  auto samples = std::vector<double>(repeats);
+  for (auto& sample : samples)
+  {
+    const auto start = clock::now();
+    w.run();
+    sample = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+  }
+
+  std::sort(samples.begin(), samples.end());
+
+  const auto n = static_cast<double>(repeats);
+  const auto mean = std::accumulate(samples.begin(), samples.end(), 0.0) / n;
+  auto variance = 0.0;
+  for (const auto sample : samples)
+    variance += (sample - mean) * (sample - mean);
+
+  const auto middle = repeats / 2u;
+  const auto median =
+    repeats % 2u ? samples[middle] : (samples[middle - 1u] + samples[middle]) / 2.0;
+
+  const auto stddev = repeats > 1u ? std::sqrt(variance / (n - 1.0)) : 0.0;
+  return {samples.front(), median, mean, stddev};
+}
+
+// The workloads, each as a vlite expression and as the loop it should compile to.  All
+// of them operate on the same vectors of `n` doubles.
+auto make_workloads(std::size_t n) -> std::vector<workload>
+{
+  using vlite::vector;
+
+  constexpr auto d = sizeof(double);
+  const auto half = n / 2u - 1u;
+
+  auto a = std::make_shared<vector<double>>(vlite::uninitialized, n);
+  auto b = std::make_shared<vector<double>>(vlite::uninitialized, n);
+  auto c = std::make_shared<vector<double>>(vlite::uninitialized, n);
+  auto both = std::make_shared<vector<double>>(vlite::uninitialized, 2u * n);
+
+  for (auto i = std::size_t{}; i < n; ++i)
+  {
+    (*a)[i] = 1.0 + static_cast<double>(i % 17u);
+    (*b)[i] = 2.0 - static_cast<double>(i % 5u);
+  }
+
+  const auto pa = a->data();
+  const auto pb = b->data();
+  const auto pc = c->data();
+  const auto pboth = both->data();
+
+  auto result = std::vector<workload>();
+
+  result.push_back({"expr_chain", "vlite", n, 3u * n * d, [=] {
+                      c->assign((*a + *b) * (*a - *b) / (*a * *a + 1.0));
+                      do_not_optimize(pc[0]);
+                    }});
+  result.push_back({"expr_chain", "raw", n, 3u * n * d, [=] {
+                      for (auto i = std::size_t{}; i < n; ++i)
+                        pc[i] = (pa[i] + pb[i]) * (pa[i] - pb[i]) / (pa[i] * pa[i] + 1.0);
+                      do_not_optimize(pc[0]);
+                    }});
+
+  result.push_back({"strided_assign", "vlite", half, 2u * half * d, [=] {
+                      (*c)[vlite::strided_slice(0u, half, 2u)] =
+                        (*a)[vlite::strided_slice(1u, half, 2u)];
+                      do_not_optimize(pc[0]);
+                    }});
+  result.push_back({"strided_assign", "raw", half, 2u * half * d, [=] {
+                      for (auto i = std::size_t{}; i < half; ++i)
+                        pc[2u * i] = pa[2u * i + 1u];
+                      do_not_optimize(pc[0]);
+                    }});
+
+  result.push_back({"cat", "vlite", 2u * n, 4u * n * d, [=] {
+                      both->assign(vlite::cat_view(*a, *b));
+                      do_not_optimize(pboth[0]);
+                    }});
+  result.push_back({"cat", "raw", 2u * n, 4u * n * d, [=] {
+                      for (auto i = std::size_t{}; i < n; ++i)
+                        pboth[i] = pa[i];
+                      for (auto i = std::size_t{}; i < n; ++i)
+                        pboth[n + i] = pb[i];
+                      do_not_optimize(pboth[0]);
+                    }});
+
+  result.push_back({"builder_fill", "vlite", n, n * d, [=] {
+                      auto filled = vlite::builder<double>(n);
+                      for (auto i = std::size_t{}; i < n; ++i)
+                        filled.unchecked_push_back(0.5 * static_cast<double>(i));
+                      const auto v = vector<double>(std::move(filled));
+                      do_not_optimize(v[n - 1u]);
+                    }});
+  // The raw builder loops allocate like the builder does, so that only the fills differ.
+  result.push_back({"builder_bulk", "vlite", n, n * d, [=] {
+                      auto filled = vlite::builder<double>(n);
+                      auto* const out = filled.uninitialized().data();
+                      for (auto i = std::size_t{}; i < n; ++i)
+                        out[i] = 0.5 * static_cast<double>(i);
+                      filled.commit(n);
+                      const auto v = vector<double>(std::move(filled));
+                      do_not_optimize(v[n - 1u]);
+                    }});
+  result.push_back({"builder_bulk", "raw", n, n * d, [=] {
+                      const auto alloc = vlite::allocator<double>{};
+                      const auto block = alloc.allocate(n);
+                      auto* const v = block.data();
+                      for (auto i = std::size_t{}; i < n; ++i)
+                        v[i] = 0.5 * static_cast<double>(i);
+                      do_not_optimize(v[n - 1u]);
+                      alloc.deallocate(block);
+                    }});
+
+  result.push_back({"builder_fill", "raw", n, n * d, [=] {
+                      const auto alloc = vlite::allocator<double>{};
+                      const auto block = alloc.allocate(n);
+                      auto* const v = block.data();
+                      for (auto i = std::size_t{}; i < n; ++i)
+                        v[i] = 0.5 * static_cast<double>(i);
+                      do_not_optimize(v[n - 1u]);
+                      alloc.deallocate(block);
+                    }});
+
+  result.push_back({"construct", "vlite", n, 3u * n * d, [=] {
+                      const auto v = vector<double>(*a * 2.0 + *b);
+                      do_not_optimize(v[n - 1u]);
+                    }});
+  result.push_back({"construct", "raw", n, 3u * n * d, [=] {
+                      const auto v = std::unique_ptr<double[]>{new double[n]};
+                      for (auto i = std::size_t{}; i < n; ++i)
+                        v[i] = pa[i] * 2.0 + pb[i];
+                      do_not_optimize(v[n - 1u]);
+                    }});
+
+  return result;
+}
+
+auto ns_per_element(const result& r) { return r.ns.median / r.source->elements; }
+
+auto gigabytes_per_second(const result& r)
+{
+  return static_cast<double>(r.source->bytes) / r.ns.median;
+}
+
+auto print_text(const std::vector<result>& results) -> void
+{
+  std::printf("%-16s %-6s %10s %10s %10s %10s %8s %8s\n", "workload", "impl", "elements",
+              "ns/elem", "min", "GB/s", "stddev%", "vs raw");
+
+  for (const auto& r : results)
+  {
+    const auto raw = std::find_if(results.begin(), results.end(), [&](const result& x) {
+      return x.source->name == r.source->name && x.source->implementation == "raw";
+    });
+
+    std::printf("%-16s %-6s %10zu %10.3f %10.3f %10.2f %8.1f", r.source->name.c_str(),
+                r.source->implementation.c_str(), r.source->elements, ns_per_element(r),
+                r.ns.min / r.source->elements, gigabytes_per_second(r),
+                100.0 * r.ns.stddev / r.ns.mean);
+    if (raw != results.end())
+      std::printf(" %7.2fx", r.ns.median / raw->ns.median);
+    std::printf("\n");
+  }
+}
+
+auto print_csv(const std::vector<result>& results, std::size_t repeats) -> void
+{
+  std::printf("workload,implementation,elements,bytes,repeats,min_ns,median_ns,mean_ns,"
+              "stddev_ns,ns_per_element,gb_per_s\n");
+  for (const auto& r : results)
+    std::printf("%s,%s,%zu,%zu,%zu,%.1f,%.1f,%.1f,%.1f,%.4f,%.3f\n",
+                r.source->name.c_str(), r.source->implementation.c_str(),
+                r.source->elements, r.source->bytes, repeats, r.ns.min, r.ns.median,
+                r.ns.mean, r.ns.stddev, ns_per_element(r), gigabytes_per_second(r));
+}
+
+auto print_json(const std::vector<result>& results, std::size_t repeats) -> void
+{
+  std::printf("[\n");
+  for (auto i = std::size_t{}; i < results.size(); ++i)
+  {
+    const auto& r = results[i];
+    std::printf("  {\"workload\": \"%s\", \"implementation\": \"%s\", \"elements\": %zu, "
+                "\"bytes\": %zu, \"repeats\": %zu, \"min_ns\": %.1f, \"median_ns\": %.1f, "
+                "\"mean_ns\": %.1f, \"stddev_ns\": %.1f, \"ns_per_element\": %.4f, "
+                "\"gb_per_s\": %.3f}%s\n",
+                r.source->name.c_str(), r.source->implementation.c_str(),
+                r.source->elements, r.source->bytes, repeats, r.ns.min, r.ns.median,
+                r.ns.mean, r.ns.stddev, ns_per_element(r), gigabytes_per_second(r),
+                i + 1u < results.size() ? "," : "");
+  }
+  std::printf("]\n");
+}
+
+} // namespace
+
+auto main(int argc, char** argv) -> int
+{
+  const auto opts = parse_options(argc, argv);
+  const auto workloads = make_workloads(opts.size);
+
+  auto results = std::vector<result>();
+  for (const auto& w : workloads)
+    if (w.name.find(opts.filter) != std::string::npos)
+      results.push_back({&w, measure(w, opts.repeats)});
+
+  if (opts.format == "csv")
+    print_csv(results, opts.repeats);
+  else if (opts.format == "json")
+    print_json(results, opts.repeats);
+  else
+    print_text(results);
+}
@@ -2,3 +2,14 @@
 #include <doctest.h>
 
 #include "vlite/vector.hpp"
+#include "vlite/arena.hpp"
+#include "vlite/cached_vector.hpp"
+#include "vlite/growable_vector.hpp"
+#if defined(__unix__) || defined(__APPLE__)
+#include "vlite/mapped_vector.hpp"
+#endif
+#include "vlite/pool.hpp"
+#include "vlite/scan.hpp"
+#include "vlite/serialization.hpp"
+#include "vlite/small_vector.hpp"
+#include "vlite/sort.hpp"
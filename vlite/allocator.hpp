@@ -3,7 +3,17 @@
 
 #include <vlite/memory_block.hpp>
 
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <memory>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
 
 namespace vlite
 {
@@ -14,20 +24,51 @@ struct uninitialized_t
 
 static constexpr auto uninitialized = uninitialized_t{};
 
-template <typename T> struct allocator
+// Default alignment of allocated blocks.  It also covers the widest vector registers, so
+// kernels never need to peel leading elements of a freshly allocated vector.
+constexpr std::size_t cache_line_size = 64u;
+
+// Size of a transparent huge page on x86-64 and aarch64 Linux.
+constexpr std::size_t huge_page_size = std::size_t{1u} << 21;
+
+template <typename T, std::size_t Alignment = cache_line_size> struct allocator
 {
   using value_type = T;
-  using storage_type = std::aligned_storage_t<sizeof(value_type), alignof(value_type)>;
   using block_type = memory_block<value_type>;
 
+  static constexpr auto alignment = std::max(Alignment, alignof(value_type));
+
+  static_assert((alignment & (alignment - 1u)) == 0u, "alignment must be a power of two");
+
   auto allocate(std::size_t size) const -> block_type
   {
-    return {reinterpret_cast<value_type*>(new storage_type[size]), size};
+    if (size > std::numeric_limits<std::size_t>::max() / sizeof(value_type))
+      throw std::bad_array_new_length{};
+
+    auto* data = ::operator new(size * sizeof(value_type), std::align_val_t{alignment});
+    return {static_cast<value_type*>(data), size, alignment};
   }
 
   auto deallocate(block_type block) const noexcept -> void
   {
-    delete[] reinterpret_cast<storage_type*>(block.data());
+    ::operator delete(block.data(), std::align_val_t{alignment});
+  }
+
+  // Resizes a block of trivially copyable elements, keeping the first
+  // `min(block.size(), size)` of them.  Shrinking happens in place.  Allocators that
+  // replace `allocate` or `deallocate` must replace this function as well.
+  auto reallocate(block_type block, std::size_t size) const -> block_type
+  {
+    static_assert(std::is_trivially_copyable_v<value_type>);
+
+    if (size <= block.size())
+      return {block.data(), size, block.alignment()};
+
+    const auto result = allocate(size);
+    if (block.data())
+      std::memcpy(result.data(), block.data(), block.size() * sizeof(value_type));
+    deallocate(block);
+    return result;
   }
 
   auto construct(block_type block) const
@@ -51,7 +92,7 @@ template <typename T> struct allocator
     std::uninitialized_copy(begin, end, block.data());
   }
 
-  template <typename It, typename R = typename std::iterator_traits<It>::reference>
+  template <typename It, typename R = decltype(*std::declval<It>())>
   auto construct(block_type block, It begin) const
     noexcept(noexcept(new (std::declval<void*>()) value_type(*begin))) -> void
   {
@@ -65,6 +106,107 @@ template <typename T> struct allocator
   }
 };
 
+// Allocator that maps blocks of at least `huge_page_size` bytes directly from the kernel,
+// aligned to a huge page boundary and advised for transparent huge pages, which reduces
+// TLB pressure when streaming over large vectors.  Smaller blocks, and every block on
+// systems without `madvise`, are served by `allocator<T>`.
+template <typename T> struct huge_page_allocator : allocator<T>
+{
+  using typename allocator<T>::value_type;
+  using typename allocator<T>::block_type;
+
+  auto allocate(std::size_t size) const -> block_type
+  {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (is_huge(size))
+    {
+      if (size > (std::numeric_limits<std::size_t>::max() - 2u * huge_page_size) /
+                   sizeof(value_type))
+        throw std::bad_array_new_length{};
+
+      // Over-map by one huge page and trim both ends to get an aligned mapping.
+      const auto bytes = mapped_bytes(size);
+      auto* raw = ::mmap(nullptr, bytes + huge_page_size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (raw == MAP_FAILED)
+        throw std::bad_alloc{};
+
+      const auto address = reinterpret_cast<std::uintptr_t>(raw);
+      const auto head = (huge_page_size - address % huge_page_size) % huge_page_size;
+      auto* data = static_cast<char*>(raw) + head;
+
+      if (head != 0u)
+        ::munmap(raw, head);
+      ::munmap(data + bytes, huge_page_size - head);
+
+      ::madvise(data, bytes, MADV_HUGEPAGE);
+      return {reinterpret_cast<value_type*>(data), size, huge_page_size};
+    }
+#endif
+    return allocator<T>::allocate(size);
+  }
+
+  auto deallocate(block_type block) const noexcept -> void
+  {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (is_huge(block.size()))
+    {
+      ::munmap(block.data(), mapped_bytes(block.size()));
+      return;
+    }
+#endif
+    allocator<T>::deallocate(block);
+  }
+
+  // Huge blocks are resized with `mremap`, which moves page table entries instead of
+  // copying; blocks that cross the huge page threshold are copied.
+  auto reallocate(block_type block, std::size_t size) const -> block_type
+  {
+#if defined(__linux__) && defined(MADV_HUGEPAGE) && defined(MREMAP_MAYMOVE)
+    if (is_huge(block.size()) && is_huge(size))
+    {
+      if (size > (std::numeric_limits<std::size_t>::max() - huge_page_size) /
+                   sizeof(value_type))
+        throw std::bad_array_new_length{};
+
+      const auto bytes = mapped_bytes(size);
+      auto* data =
+        ::mremap(block.data(), mapped_bytes(block.size()), bytes, MREMAP_MAYMOVE);
+      if (data == MAP_FAILED)
+        throw std::bad_alloc{};
+
+      ::madvise(data, bytes, MADV_HUGEPAGE);
+
+      // A moved mapping is only guaranteed to be page aligned.
+      const auto address = reinterpret_cast<std::uintptr_t>(data);
+      const auto alignment = std::min(address & (~address + 1u), huge_page_size);
+      return {static_cast<value_type*>(data), size, alignment};
+    }
+#endif
+    if (!is_huge(block.size()) && !is_huge(size))
+      return allocator<T>::reallocate(block, size);
+
+    const auto result = allocate(size);
+    if (block.data())
+      std::memcpy(result.data(), block.data(),
+                  std::min(block.size(), size) * sizeof(value_type));
+    deallocate(block);
+    return result;
+  }
+
+private:
+  static constexpr auto is_huge(std::size_t size) noexcept
+  {
+    return size >= huge_page_size / sizeof(value_type);
+  }
+
+  static constexpr auto mapped_bytes(std::size_t size) noexcept
+  {
+    return (size * sizeof(value_type) + huge_page_size - 1u) / huge_page_size *
+           huge_page_size;
+  }
+};
+
 } // namespace vlite
 
 #ifdef DOCTEST_LIBRARY_INCLUDED
@@ -85,6 +227,38 @@ TEST_CASE("[allocator] Allocation and deallocation")
   allocator.deallocate(block);
 }
 
+TEST_CASE("[allocator] Aligned allocation")
+{
+  const auto is_aligned = [](const auto& block, std::size_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(block.data()) % alignment == 0u;
+  };
+
+  const auto allocator = vlite::allocator<char>{};
+  for (const auto size : {0u, 1u, 3u, 100u})
+  {
+    const auto block = allocator.allocate(size);
+    CHECK(block.alignment() == vlite::cache_line_size);
+    CHECK(is_aligned(block, vlite::cache_line_size));
+    allocator.deallocate(block);
+  }
+
+  const auto page_allocator = vlite::allocator<float, 4096u>{};
+  const auto page_block = page_allocator.allocate(10u);
+  CHECK(is_aligned(page_block, 4096u));
+  page_allocator.deallocate(page_block);
+
+  const auto huge_allocator = vlite::huge_page_allocator<double>{};
+  for (const auto size : {std::size_t{10u}, 3u * vlite::huge_page_size / sizeof(double) + 1u})
+  {
+    const auto block = huge_allocator.allocate(size);
+    CHECK(is_aligned(block, block.alignment()));
+    huge_allocator.construct(block);
+    CHECK(std::all_of(block.begin(), block.end(), [](auto v) { return v == 0.0; }));
+    huge_allocator.destroy(block);
+    huge_allocator.deallocate(block);
+  }
+}
+
 #endif // DOCTEST_LIBRARY_INCLUDED
 
 #endif // VLITE_ALLOCATOR_HPP_INCLUDED
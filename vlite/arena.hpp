@@ -0,0 +1,249 @@
+#ifndef VLITE_ARENA_HPP_INCLUDED
+#define VLITE_ARENA_HPP_INCLUDED
+
+#include <vlite/allocator.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <utility>
+
+namespace vlite
+{
+
+// Monotonic memory resource for short-lived vectors.  Allocations bump a pointer inside
+// large chunks; deallocating a single block is a no-op and all the memory is given back at
+// once, either by `reset`, which keeps memory around for the next batch, or by `release`.
+class monotonic_arena
+{
+public:
+  static constexpr std::size_t default_chunk_size = std::size_t{1u} << 20;
+
+  explicit monotonic_arena(std::size_t chunk_size = default_chunk_size) noexcept
+    : chunk_size_{chunk_size}
+  {
+  }
+
+  ~monotonic_arena() { release(); }
+
+  monotonic_arena(const monotonic_arena&) = delete;
+  monotonic_arena(monotonic_arena&&) = delete;
+
+  auto operator=(const monotonic_arena&) -> monotonic_arena& = delete;
+  auto operator=(monotonic_arena&&) -> monotonic_arena& = delete;
+
+  // Returns `bytes` bytes aligned to `alignment`, which must be a power of two.
+  auto allocate(std::size_t bytes, std::size_t alignment) -> void*
+  {
+    assert(alignment != 0u && (alignment & (alignment - 1u)) == 0u);
+
+    auto offset = head_ ? aligned_offset(alignment) : 0u;
+    if (!head_ || offset > head_->size || bytes > head_->size - offset)
+    {
+      // Chunk data is only aligned to `alignof(chunk)`, so wider alignments need room to
+      // round up the start of the block.
+      const auto padding = std::max(alignment, alignof(chunk)) - alignof(chunk);
+      if (bytes > std::numeric_limits<std::size_t>::max() - padding)
+        throw std::bad_alloc{};
+
+      grow(bytes + padding);
+      used_ = 0u;
+      offset = aligned_offset(alignment);
+    }
+
+    used_ = offset + bytes;
+    allocated_ += bytes;
+    return head_->data() + offset;
+  }
+
+  // Makes all the memory available again.  When the last batch spilled over several
+  // chunks they are coalesced into one on the next allocation, so that a loop that
+  // allocates the same amount per iteration stops requesting memory after the first pass.
+  auto reset() noexcept -> void
+  {
+    if (head_ && head_->previous)
+    {
+      chunk_size_ = std::max(chunk_size_, capacity_);
+      release();
+    }
+
+    used_ = 0u;
+    allocated_ = 0u;
+  }
+
+  // Returns every chunk to the system.
+  auto release() noexcept -> void
+  {
+    free_chunks(std::exchange(head_, nullptr));
+    capacity_ = 0u;
+    used_ = 0u;
+    allocated_ = 0u;
+  }
+
+  // Bytes handed out since the last `reset` or `release`.
+  auto allocated() const noexcept { return allocated_; }
+
+  // Bytes currently obtained from the system.
+  auto capacity() const noexcept { return capacity_; }
+
+private:
+  struct alignas(cache_line_size) chunk
+  {
+    chunk* previous;
+    std::size_t size;
+
+    auto data() noexcept -> char* { return reinterpret_cast<char*>(this + 1); }
+  };
+
+  // Offset in the head chunk of the first address past the used bytes that is aligned to
+  // `alignment`.
+  auto aligned_offset(std::size_t alignment) noexcept -> std::size_t
+  {
+    const auto address = reinterpret_cast<std::uintptr_t>(head_->data() + used_);
+    return used_ + ((~address + 1u) & (alignment - 1u));
+  }
+
+  auto grow(std::size_t bytes) -> void
+  {
+    const auto size = std::max(bytes, chunk_size_);
+    if (size > std::numeric_limits<std::size_t>::max() - sizeof(chunk))
+      throw std::bad_alloc{};
+
+    auto* memory = ::operator new(sizeof(chunk) + size, std::align_val_t{alignof(chunk)});
+    head_ = ::new (memory) chunk{head_, size};
+    capacity_ += size;
+  }
+
+  static auto free_chunks(chunk* current) noexcept -> void
+  {
+    while (current)
+    {
+      auto* previous = current->previous;
+      ::operator delete(current, std::align_val_t{alignof(chunk)});
+      current = previous;
+    }
+  }
+
+  std::size_t chunk_size_;
+  chunk* head_ = nullptr;
+  std::size_t capacity_ = 0u;
+  std::size_t used_ = 0u;
+  std::size_t allocated_ = 0u;
+};
+
+// Allocator that takes its blocks from a `monotonic_arena`.  The arena must outlive every
+// vector that uses it.
+template <typename T> class arena_allocator : public allocator<T>
+{
+public:
+  using typename allocator<T>::value_type;
+  using typename allocator<T>::block_type;
+  using allocator<T>::alignment;
+
+  arena_allocator(monotonic_arena& arena) noexcept
+    : arena_{&arena}
+  {
+  }
+
+  auto allocate(std::size_t size) const -> block_type
+  {
+    if (size > std::numeric_limits<std::size_t>::max() / sizeof(value_type))
+      throw std::bad_array_new_length{};
+
+    auto* data = arena_->allocate(size * sizeof(value_type), alignment);
+    return {static_cast<value_type*>(data), size, alignment};
+  }
+
+  auto deallocate(block_type) const noexcept -> void {}
+
+  auto reallocate(block_type block, std::size_t size) const -> block_type
+  {
+    static_assert(std::is_trivially_copyable_v<value_type>);
+
+    if (size <= block.size())
+      return {block.data(), size, block.alignment()};
+
+    const auto result = allocate(size);
+    if (block.data())
+      std::memcpy(result.data(), block.data(), block.size() * sizeof(value_type));
+    return result;
+  }
+
+  auto arena() const noexcept -> monotonic_arena& { return *arena_; }
+
+private:
+  monotonic_arena* arena_;
+};
+
+} // namespace vlite
+
+#ifdef DOCTEST_LIBRARY_INCLUDED
+
+#include <vlite/vector.hpp>
+
+TEST_CASE("[arena] Request-scoped vectors")
+{
+  using namespace vlite;
+  using arena_vector = vector<double, arena_allocator<double>>;
+
+  auto arena = monotonic_arena{1024u};
+
+  auto capacity = std::size_t{};
+  for (auto request = 0; request < 3; ++request)
+  {
+    {
+      const auto a = arena_vector(1.0, 100u, arena);
+      const auto b = arena_vector(a * 2.0 + 1.0, arena);
+      auto c = arena_vector(uninitialized, 1000u, arena);
+      c[every] = 0.0;
+
+      CHECK(all(b == 3.0));
+      CHECK(reinterpret_cast<std::uintptr_t>(c.data()) % cache_line_size == 0u);
+      CHECK(arena.allocated() == 1200u * sizeof(double));
+
+      const auto d = arena_vector(std::move(c));
+      CHECK(&d.get_allocator().arena() == &arena);
+      CHECK(all(d == 0.0));
+    }
+
+    // Later batches fit in the chunk coalesced from the first one.
+    if (request > 0)
+      CHECK(arena.capacity() == capacity);
+    capacity = arena.capacity();
+
+    arena.reset();
+  }
+
+  arena.release();
+  CHECK(arena.allocated() == 0u);
+}
+
+TEST_CASE("[arena] Over-aligned blocks")
+{
+  using namespace vlite;
+
+  struct alignas(4u * cache_line_size) wide
+  {
+    double x;
+  };
+
+  auto arena = monotonic_arena{1024u};
+  const auto alignments = {std::size_t{8u}, 4u * cache_line_size, 16u * cache_line_size};
+  for (const auto alignment : alignments)
+  {
+    const auto* data = arena.allocate(24u, alignment);
+    CHECK(reinterpret_cast<std::uintptr_t>(data) % alignment == 0u);
+  }
+
+  const auto a = vector<wide, arena_allocator<wide>>(wide{1.0}, 10u, arena);
+  CHECK(reinterpret_cast<std::uintptr_t>(a.data()) % alignof(wide) == 0u);
+  CHECK(a[9].x == 1.0);
+}
+
+#endif // DOCTEST_LIBRARY_INCLUDED
+
+#endif // VLITE_ARENA_HPP_INCLUDED
@@ -3,119 +3,76 @@
 
 #include <vlite/common_vector_base.hpp>
 #include <vlite/expr_vector.hpp>
+#include <vlite/iterator_traits.hpp>
 
-#include <iterator>
+#include <cassert>
+#include <type_traits>
 
 namespace vlite
 {
 
-template <typename LhsIt, typename RhsIt, typename Op>
+template <typename Lhs, typename Rhs, typename Op>
 class binary_expr_vector : public expr_vector<Op>,
-                           public common_vector_base<binary_expr_vector<LhsIt, RhsIt, Op>>
+                           public common_vector_base<binary_expr_vector<Lhs, Rhs, Op>>
 {
-  using lhs_result = decltype(*std::declval<LhsIt>());
-  using rhs_result = decltype(*std::declval<RhsIt>());
+  using lhs_result = detail::operand_result_t<Lhs>;
+  using rhs_result = detail::operand_result_t<Rhs>;
 
 public:
-  using value_type = std::decay_t<std::result_of_t<Op(lhs_result, rhs_result)>>;
+  using value_type = std::decay_t<std::invoke_result_t<const Op&, lhs_result, rhs_result>>;
 
   using typename expr_vector<Op>::size_type;
 
   using typename expr_vector<Op>::difference_type;
 
-  class iterator
-  {
-    friend class binary_expr_vector<LhsIt, RhsIt, Op>;
-
-  public:
-    using iterator_category = std::input_iterator_tag;
-    using value_type = std::decay_t<std::result_of_t<Op(lhs_result, rhs_result)>>;
-    using difference_type = std::ptrdiff_t;
-    using reference = void;
-    using pointer = void;
-
-    constexpr iterator() = default;
-
-    constexpr iterator(const iterator& source) = default;
-    constexpr iterator(iterator&& source) noexcept = default;
-
-    constexpr iterator& operator=(const iterator& source) = default;
-    constexpr iterator& operator=(iterator&& source) noexcept = default;
-
-    constexpr auto operator++() -> iterator&
-    {
-      ++lhs_;
-      ++rhs_;
-      return *this;
-    }
-
-    constexpr auto operator++(int) -> iterator
-    {
-      auto copy = *this;
-      ++(*this);
-      return copy;
-    }
-
-    constexpr auto operator==(const iterator& other) const
-    {
-      return lhs_ == other.lhs_ && rhs_ == other.rhs_;
-    }
-
-    constexpr auto operator!=(const iterator& other) const { return !(*this == other); }
-
-    constexpr auto operator*() const -> value_type
-    {
-      return source_->operate(*lhs_, *rhs_);
-    }
-
-  private:
-    constexpr iterator(LhsIt lhs, RhsIt rhs, const binary_expr_vector* source)
-      : lhs_{lhs}
-      , rhs_{rhs}
-      , source_{source}
-    {
-    }
-
-    LhsIt lhs_;
-    RhsIt rhs_;
-    const binary_expr_vector* source_;
-  };
+  static constexpr bool is_contiguous =
+    detail::is_contiguous_iterator_v<Lhs> && detail::is_contiguous_iterator_v<Rhs>;
+
+  using iterator = expr_iterator<binary_expr_vector>;
 
   using const_iterator = iterator;
 
-public:
-  binary_expr_vector(LhsIt lhs_first, LhsIt lhs_last, RhsIt rhs_first, RhsIt rhs_last,
-                     const Op& op, std::size_t size)
+  binary_expr_vector(Lhs lhs, Rhs rhs, Op op, std::size_t size)
     : expr_vector<Op>(std::move(op), size)
-    , lhs_first_{lhs_first}
-    , lhs_last_{lhs_last}
-    , rhs_first_{rhs_first}
-    , rhs_last_{rhs_last}
+    , lhs_{std::move(lhs)}
+    , rhs_{std::move(rhs)}
   {
   }
 
-  binary_expr_vector(const binary_expr_vector& source) = delete;
-  binary_expr_vector(binary_expr_vector&& source) noexcept = delete;
-
-  auto operator=(const binary_expr_vector& source) -> binary_expr_vector& = delete;
-  auto operator=(binary_expr_vector&& source) noexcept -> binary_expr_vector& = delete;
-
   auto begin() const -> const_iterator { return cbegin(); }
   auto end() const -> const_iterator { return cend(); }
 
-  auto cbegin() const -> const_iterator { return {lhs_first_, rhs_first_, this}; }
-  auto cend() const -> const_iterator { return {lhs_last_, rhs_last_, this}; }
+  auto cbegin() const -> const_iterator { return {this, 0}; }
+  auto cend() const -> const_iterator
+  {
+    return {this, static_cast<difference_type>(size())};
+  }
+
+  auto operator[](size_type i) const -> value_type
+  {
+    assert(i < size());
+    return compute(i);
+  }
+
+  // Element at `i`, without bounds checks, for the iterators and the parent nodes.
+  auto compute(size_type i) const -> value_type
+  {
+    return this->operate(detail::operand_at(lhs_, i), detail::operand_at(rhs_, i));
+  }
 
   using expr_vector<Op>::size;
 
+  // Operands of the node, for the rewrites that fuse it with its parent.
+  auto lhs() const -> const Lhs& { return lhs_; }
+  auto rhs() const -> const Rhs& { return rhs_; }
+
 private:
-  LhsIt lhs_first_, lhs_last_;
-  RhsIt rhs_first_, rhs_last_;
+  Lhs lhs_;
+  Rhs rhs_;
 };
 
-template <typename LhsIt, typename RhsIt, typename Op>
-binary_expr_vector(LhsIt, LhsIt, RhsIt, RhsIt, Op, std::size_t)
-  ->binary_expr_vector<LhsIt, RhsIt, Op>;
+template <typename Lhs, typename Rhs, typename Op>
+binary_expr_vector(Lhs, Rhs, Op, std::size_t)->binary_expr_vector<Lhs, Rhs, Op>;
 
 } // namespace vlite
 
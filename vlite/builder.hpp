@@ -2,19 +2,31 @@
 #define VLITE_BUILDER_HPP_INCLUDED
 
 #include <vlite/allocator.hpp>
+#include <vlite/common_vector_base.hpp>
+#include <vlite/evaluation.hpp>
+#include <vlite/iterator_traits.hpp>
 
 #include <cassert>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 namespace vlite
 {
 
-template <typename T> class builder : private allocator<T>
+template <typename T, typename Allocator = allocator<T>>
+class builder : private Allocator
 {
 public:
   using value_type = T;
 
-  explicit builder(std::size_t size)
-    : block_{this->allocate(size)}
+  using allocator_type = Allocator;
+
+  explicit builder(std::size_t size, const Allocator& alloc = Allocator{})
+    : Allocator{alloc}
+    , block_{this->allocate(size)}
   {
   }
 
@@ -30,7 +42,8 @@ public:
   builder(const builder&) = delete;
 
   builder(builder&& source) noexcept
-    : block_{std::exchange(source.block_, {})}
+    : Allocator{source.get_allocator()}
+    , block_{std::exchange(source.block_, {})}
     , count_{std::exchange(source.count_, 0u)}
   {
   }
@@ -41,6 +54,8 @@ public:
   {
     std::swap(block_, source.block_);
     std::swap(count_, source.count_);
+    std::swap(static_cast<Allocator&>(*this), static_cast<Allocator&>(source));
+    return *this;
   }
 
   auto is_complete() const noexcept { return count_ == block_.size(); }
@@ -72,10 +87,84 @@ public:
     ++count_;
   }
 
+  // Variants of `push_back` and `emplace_back` for callers that already know there is
+  // room left, e.g. because they checked `remaining()` once for a whole batch.
+  auto unchecked_push_back(const T& value)
+  {
+    assert(!is_complete());
+    ::new (static_cast<void*>(block_.data() + count_)) T(value);
+    ++count_;
+  }
+
+  auto unchecked_push_back(T&& value)
+  {
+    assert(!is_complete());
+    ::new (static_cast<void*>(block_.data() + count_)) T(std::move(value));
+    ++count_;
+  }
+
+  template <typename... Args> auto unchecked_emplace_back(Args&&... args)
+  {
+    assert(!is_complete());
+    ::new (static_cast<void*>(block_.data() + count_)) T(std::forward<Args>(args)...);
+    ++count_;
+  }
+
+  // Appends the elements in `[first, last)`.  The room left is checked once for the
+  // whole range when it is random access, and trivially copyable elements are copied in
+  // bulk.
+  template <typename It> auto append(It first, It last) -> void
+  {
+    if constexpr (detail::is_random_access_iterator<It>::value)
+    {
+      const auto size = static_cast<std::size_t>(std::distance(first, last));
+      check_room(size);
+      append_n(first, size);
+    }
+    else
+    {
+      for (; first != last; ++first)
+        emplace_back(*first);
+    }
+  }
+
+  template <typename Vector> auto append(const common_vector_base<Vector>& source) -> void
+  {
+    check_room(source.size());
+
+    if constexpr (detail::has_evaluate_to<Vector, value_type>::value &&
+                  std::is_trivially_copyable_v<value_type> &&
+                  std::is_trivially_default_constructible_v<value_type>)
+    {
+      detail::evaluate(source, uninitialized_n(source.size()));
+      count_ += source.size();
+    }
+    else
+      append_n(source.begin(), source.size());
+  }
+
+  // Storage past the elements added so far.  It may be written directly, e.g. by a read
+  // from a file, and the elements constructed in it are then published with `commit`.
+  auto uninitialized() noexcept -> memory_block<value_type>
+  {
+    return uninitialized_n(remaining());
+  }
+
+  // Marks the first `size` elements of `uninitialized()` as constructed.
+  auto commit(std::size_t size) -> void
+  {
+    check_room(size);
+    count_ += size;
+  }
+
   auto size() const noexcept { return block_.size(); }
 
   auto count() const noexcept { return count_; }
 
+  auto remaining() const noexcept { return block_.size() - count_; }
+
+  auto get_allocator() const noexcept -> Allocator { return *this; }
+
   auto release()
   {
     if (!is_complete())
@@ -86,6 +175,42 @@ public:
   }
 
 private:
+  auto uninitialized_n(std::size_t size) const noexcept -> memory_block<value_type>
+  {
+    return {block_.data() + count_, size};
+  }
+
+  auto check_room(std::size_t size) const -> void
+  {
+    if (size > remaining())
+      throw std::runtime_error{"builder is too small"};
+  }
+
+  template <typename It> auto append_n(It first, std::size_t size) -> void
+  {
+    using source_type = typename std::iterator_traits<It>::value_type;
+    auto* out = block_.data() + count_;
+
+    if constexpr (std::is_pointer_v<It> && std::is_same_v<source_type, value_type> &&
+                  std::is_trivially_copyable_v<value_type>)
+    {
+      if (size > 0u)
+        std::memcpy(out, first, size * sizeof(value_type));
+      count_ += size;
+    }
+    else if constexpr (std::is_trivially_copyable_v<value_type> &&
+                       std::is_trivially_default_constructible_v<value_type>)
+    {
+      detail::evaluate_n(first, size, out);
+      count_ += size;
+    }
+    else
+    {
+      for (auto i = std::size_t{}; i < size; ++i, ++first)
+        unchecked_emplace_back(*first);
+    }
+  }
+
   memory_block<value_type> block_;
   std::size_t count_ = 0u;
 };
@@ -94,6 +219,14 @@ private:
 
 #ifdef DOCTEST_LIBRARY_INCLUDED
 
+#include <vlite/functional.hpp>
+#include <vlite/ref_vector.hpp>
+
+#include <algorithm>
+#include <list>
+#include <string>
+#include <vector>
+
 TEST_CASE("[builder] Building an vector in parts")
 {
   auto a = vlite::builder<double>(10u);
@@ -113,6 +246,38 @@ TEST_CASE("[builder] Building an vector in parts")
   allocator.deallocate(block);
 }
 
+// vector.hpp includes this header, so the expressions here are built on ref_vector.
+TEST_CASE("[builder] Appending ranges")
+{
+  using namespace vlite;
+
+  const auto values = std::vector<double>{1.0, 2.0, 3.0};
+  auto more = std::vector<double>{4.0, 5.0};
+  auto d = builder<double>(6u);
+  d.append(values.begin(), values.end());
+  d.append(ref_vector<double>({more.data(), more.size()}) * 2.0);
+  CHECK(d.remaining() == 1u);
+  CHECK_THROWS(d.append(values.begin(), values.end()));
+
+  auto span = d.uninitialized();
+  CHECK(span.size() == 1u);
+  span.data()[0] = 6.0;
+  d.commit(1u);
+  CHECK_THROWS(d.commit(1u));
+
+  const auto expected = {1.0, 2.0, 3.0, 8.0, 10.0, 6.0};
+  const auto e = d.release();
+  CHECK(std::equal(expected.begin(), expected.end(), e.data(), e.data() + e.size()));
+  d.get_allocator().destroy(e);
+  d.get_allocator().deallocate(e);
+
+  auto f = builder<std::string>(3u);
+  const auto words = std::list<const char*>{"a", "b"};
+  f.append(words.begin(), words.end());
+  f.unchecked_push_back("c");
+  CHECK(f.is_complete());
+}
+
 #endif // DOCTEST_LIBRARY_INCLUDED
 
 #endif // VLITE_BUILDER_HPP_INCLUDED
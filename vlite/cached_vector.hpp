@@ -0,0 +1,164 @@
+#ifndef VLITE_CACHED_VECTOR_HPP_INCLUDED
+#define VLITE_CACHED_VECTOR_HPP_INCLUDED
+
+#include <vlite/common_vector_base.hpp>
+#include <vlite/expr_vector.hpp>
+#include <vlite/pool.hpp>
+#include <vlite/vector.hpp>
+
+#include <cassert>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace vlite
+{
+
+// Expression that is evaluated into a buffer the first time it is traversed; later
+// traversals, and the expressions that use it as an operand, read that buffer instead of
+// recomputing the whole chain.  The default allocator recycles the buffer through the
+// thread-local pool.
+//
+// The leaves of the expression are read once: the cache does not see later changes to
+// them until `invalidate()` is called.  Like the evaluation of any expression, the first
+// traversal must not race with another traversal of the same object.
+//
+// As an operand, a cached vector is read through its buffer, which is allocated once and
+// kept until the cached vector is destroyed: expressions built from it must not outlive
+// it, but they stay valid across `invalidate()`.  They read the values of the last
+// evaluation, and see new ones once the cached vector has been traversed again.
+template <typename Expr,
+          typename Allocator = pool_allocator<std::decay_t<typename Expr::value_type>>>
+class cached_vector : public common_vector_base<cached_vector<Expr, Allocator>>
+{
+  static_assert(detail::is_expression_node<Expr>::value, "only expressions are cached");
+
+public:
+  using value_type = std::decay_t<typename Expr::value_type>;
+
+  using allocator_type = Allocator;
+
+  using buffer_type = vector<value_type, Allocator>;
+
+  using iterator = typename buffer_type::const_iterator;
+
+  using const_iterator = iterator;
+
+  using size_type = std::size_t;
+
+  using difference_type = std::ptrdiff_t;
+
+  explicit cached_vector(Expr expr, const Allocator& alloc = Allocator{})
+    : expr_{std::move(expr)}
+    , allocator_{alloc}
+  {
+  }
+
+  auto begin() const -> const_iterator { return cbegin(); }
+  auto end() const -> const_iterator { return cend(); }
+
+  auto cbegin() const -> const_iterator { return values().begin(); }
+  auto cend() const -> const_iterator { return values().end(); }
+
+  auto operator[](size_type i) const -> const value_type&
+  {
+    assert(i < size());
+    return values()[i];
+  }
+
+  auto size() const noexcept { return expr_.size(); }
+
+  auto is_cached() const noexcept { return buffer_.has_value() && !is_stale_; }
+
+  // Evaluated elements, computing them on the first call after construction or
+  // `invalidate()`.
+  auto values() const -> const buffer_type&
+  {
+    if (!buffer_)
+      buffer_.emplace(expr_, allocator_);
+    else if (is_stale_)
+      buffer_->assign(expr_);
+    is_stale_ = false;
+    return *buffer_;
+  }
+
+  // Marks the buffer as stale, so that the next traversal evaluates the expression again
+  // into the same buffer.
+  auto invalidate() noexcept -> void { is_stale_ = true; }
+
+  auto expression() const noexcept -> const Expr& { return expr_; }
+
+private:
+  Expr expr_;
+  Allocator allocator_;
+  mutable std::optional<buffer_type> buffer_;
+  mutable bool is_stale_ = false;
+};
+
+template <typename Vector> auto cache(const common_vector_base<Vector>& expr)
+{
+  return cached_vector<Vector>(static_cast<const Vector&>(expr));
+}
+
+template <typename Vector, typename Allocator>
+auto cache(const common_vector_base<Vector>& expr, const Allocator& alloc)
+{
+  return cached_vector<Vector, Allocator>(static_cast<const Vector&>(expr), alloc);
+}
+
+} // namespace vlite
+
+#ifdef DOCTEST_LIBRARY_INCLUDED
+
+TEST_CASE("[cached_vector] Evaluating a shared subexpression once")
+{
+  using namespace vlite;
+
+  auto a = vector{1.0, 2.0, 3.0, 4.0};
+  auto calls = std::size_t{};
+  const auto square = [&calls](double x) {
+    ++calls;
+    return x * x;
+  };
+
+  const auto lazy = apply(a, square);
+  CHECK(all(lazy > 0.0));
+  const auto copy = vector(lazy);
+  CHECK(calls == 2 * a.size());
+
+  calls = 0u;
+  const auto shared = cache(lazy);
+  CHECK(!shared.is_cached());
+  CHECK(calls == 0u);
+
+  const auto b = eval(shared + 1.0);
+  const auto c = eval(shared * shared);
+  CHECK(shared.is_cached());
+  CHECK(calls == a.size());
+  CHECK(all(b == vector{2.0, 5.0, 10.0, 17.0}));
+  CHECK(all(c == vector{1.0, 16.0, 81.0, 256.0}));
+  CHECK(all(shared == copy));
+
+  auto stale = cache(a * 2.0);
+  CHECK(stale[3] == 8.0);
+  a[3] = 5.0;
+  CHECK(stale[3] == 8.0);
+  stale.invalidate();
+  CHECK(!stale.is_cached());
+  CHECK(stale[3] == 10.0);
+  CHECK(stale.is_cached());
+
+  // Expressions that read the cache stay valid across `invalidate()`.
+  const auto* buffer = stale.values().data();
+  const auto doubled = stale * 2.0;
+  a[3] = 6.0;
+  stale.invalidate();
+  CHECK(doubled[3] == 20.0);
+  CHECK(stale[3] == 12.0);
+  CHECK(stale.values().data() == buffer);
+  CHECK(doubled[3] == 24.0);
+}
+
+#endif // DOCTEST_LIBRARY_INCLUDED
+
+#endif // VLITE_CACHED_VECTOR_HPP_INCLUDED
@@ -0,0 +1,183 @@
+#ifndef VLITE_CAT_VECTOR_HPP_INCLUDED
+#define VLITE_CAT_VECTOR_HPP_INCLUDED
+
+#include <vlite/common_vector_base.hpp>
+#include <vlite/evaluation.hpp>
+#include <vlite/expr_vector.hpp>
+#include <vlite/parallel.hpp>
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace vlite
+{
+
+namespace detail
+{
+
+template <typename Vector>
+constexpr auto cat_size(const common_vector_base<Vector>& vec) noexcept -> std::size_t
+{
+  return vec.size();
+}
+
+template <typename T, typename = meta::fallback<CommonVector<T>>>
+constexpr auto cat_size(const T&) noexcept -> std::size_t
+{
+  return 1u;
+}
+
+} // namespace detail
+
+// Lazy concatenation of vectors and scalars, built by `cat_view`.  Like the other
+// expression nodes it can be an operand, reduced or assigned without allocating; when it
+// is evaluated into contiguous storage, each piece is written by its own kernel and arrays
+// of the destination type are copied with memcpy.
+template <typename... Pieces>
+class cat_vector : public detail::expression_node,
+                   public common_vector_base<cat_vector<Pieces...>>
+{
+  static constexpr auto piece_count = sizeof...(Pieces);
+
+public:
+  using value_type =
+    std::common_type_t<std::decay_t<detail::operand_result_t<Pieces>>...>;
+
+  using size_type = std::size_t;
+
+  using difference_type = std::ptrdiff_t;
+
+  static constexpr bool is_contiguous = false;
+
+  using iterator = expr_iterator<cat_vector>;
+
+  using const_iterator = iterator;
+
+  cat_vector(std::tuple<Pieces...> pieces, std::array<std::size_t, piece_count> sizes)
+    : pieces_{std::move(pieces)}
+    , sizes_{sizes}
+  {
+    for (const auto n : sizes_)
+      size_ += n;
+  }
+
+  auto begin() const -> const_iterator { return cbegin(); }
+  auto end() const -> const_iterator { return cend(); }
+
+  auto cbegin() const -> const_iterator { return {this, 0}; }
+  auto cend() const -> const_iterator
+  {
+    return {this, static_cast<difference_type>(size())};
+  }
+
+  auto operator[](size_type i) const -> value_type
+  {
+    assert(i < size());
+    return compute(i);
+  }
+
+  // Element at `i`, without bounds checks, for the iterators and the parent nodes.
+  auto compute(size_type i) const -> value_type { return compute_from<0u>(i); }
+
+  auto size() const noexcept { return size_; }
+
+  // Writes every element into `out`, which no piece reads, one piece at a time.
+  template <typename T> auto evaluate_to(T* out) const -> void
+  {
+    evaluate_pieces(out, std::index_sequence_for<Pieces...>{});
+  }
+
+  // Like `evaluate_to`, for an `out` that the pieces may read, e.g. to rotate a vector:
+  // the pieces are then written to a temporary first.
+  template <typename T> auto assign_to(T* out) const -> void
+  {
+    const auto pieces = std::index_sequence_for<Pieces...>{};
+
+    if (overlaps(out, pieces))
+    {
+      auto values = std::vector<T>(size());
+      evaluate_pieces(values.data(), pieces);
+      std::move(values.begin(), values.end(), out);
+    }
+    else
+      evaluate_pieces(out, pieces);
+  }
+
+private:
+  template <std::size_t K> auto compute_from(size_type i) const -> value_type
+  {
+    if constexpr (K + 1u == piece_count)
+      return static_cast<value_type>(detail::operand_at(std::get<K>(pieces_), i));
+    else if (i < sizes_[K])
+      return static_cast<value_type>(detail::operand_at(std::get<K>(pieces_), i));
+    else
+      return compute_from<K + 1u>(i - sizes_[K]);
+  }
+
+  // Whether a piece may read the `size()` elements at `out`.  The storage read by
+  // expression pieces is unknown, and they are written at other positions than the ones
+  // they read, so any of them is assumed to.
+  template <typename T, std::size_t... Ks>
+  auto overlaps(const T* out, std::index_sequence<Ks...>) const -> bool
+  {
+    const auto piece_overlaps = [&](const auto& piece, std::size_t size) {
+      using piece_type = std::decay_t<decltype(piece)>;
+      if constexpr (detail::is_broadcast<piece_type>::value)
+        return false;
+      else if constexpr (detail::is_expression_node<piece_type>::value)
+        return size > 0u;
+      else
+        return detail::may_overlap(piece, size, out, size_);
+    };
+    return (piece_overlaps(std::get<Ks>(pieces_), sizes_[Ks]) || ...);
+  }
+
+  template <typename T, std::size_t... Ks>
+  auto evaluate_pieces(T* out, std::index_sequence<Ks...>) const -> void
+  {
+    ((evaluate_piece(std::get<Ks>(pieces_), sizes_[Ks], out), out += sizes_[Ks]), ...);
+  }
+
+  // Arrays of the destination type are copied with memcpy, in parallel when they are very
+  // large; anything else goes through the evaluation kernels.
+  template <typename Piece, typename T>
+  static auto evaluate_piece(const Piece& piece, std::size_t size, T* out) -> void
+  {
+    if constexpr (detail::is_broadcast<Piece>::value)
+      *out = piece.compute(0u);
+    else if constexpr (detail::is_expression_node<Piece>::value)
+      detail::evaluate_n(piece.begin(), size, out);
+    else if constexpr (std::is_pointer_v<Piece> &&
+                       std::is_same_v<std::remove_cv_t<std::remove_pointer_t<Piece>>, T> &&
+                       std::is_trivially_copyable_v<T>)
+      detail::parallel_copy_n(static_cast<const T*>(piece), size, out);
+    else
+      detail::evaluate_n(piece, size, out);
+  }
+
+  std::tuple<Pieces...> pieces_;
+  std::array<std::size_t, piece_count> sizes_;
+  std::size_t size_ = 0u;
+};
+
+// Concatenates vectors and scalars, in order, into a lazy expression.  Expressions are
+// stored by value, but vectors are referenced: `cat_view(vector{1, 2}, x)` must be
+// evaluated before the end of the statement that creates the temporary vector.  `cat`
+// evaluates the concatenation into a new vector.
+template <typename... Args> auto cat_view(const Args&... args)
+{
+  static_assert(sizeof...(Args) > 0u, "nothing to concatenate");
+
+  return cat_vector<decltype(detail::make_operand(args))...>(
+    std::tuple{detail::make_operand(args)...},
+    std::array<std::size_t, sizeof...(Args)>{detail::cat_size(args)...});
+}
+
+} // namespace vlite
+
+#endif // VLITE_CAT_VECTOR_HPP_INCLUDED
@@ -0,0 +1,664 @@
+#ifndef VLITE_EVALUATION_HPP_INCLUDED
+#define VLITE_EVALUATION_HPP_INCLUDED
+
+#include <vlite/common_vector_base.hpp>
+#include <vlite/iterator_traits.hpp>
+#include <vlite/memory_block.hpp>
+#include <vlite/strided_iterator.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace vlite::detail
+{
+
+// Alignment, in bytes, of the widest vector registers the kernels target.
+constexpr std::size_t simd_alignment = 64u;
+
+// Number of elements computed per block by the contiguous kernels.
+constexpr std::size_t evaluation_block_size = 64u;
+
+template <typename Vector>
+using const_iterator_t = decltype(std::declval<const Vector&>().begin());
+
+template <typename OutIt, typename It>
+struct is_vectorizable_iterator
+  : std::conjunction<std::is_pointer<OutIt>,
+                     std::is_arithmetic<typename std::iterator_traits<OutIt>::value_type>,
+                     std::is_arithmetic<typename std::iterator_traits<It>::value_type>,
+                     is_contiguous_iterator<It>>
+{
+};
+
+template <typename T, typename Vector>
+struct is_vectorizable : is_vectorizable_iterator<T*, const_iterator_t<Vector>>
+{
+};
+
+template <typename T, typename Vector>
+constexpr auto is_vectorizable_v = is_vectorizable<T, Vector>::value;
+
+template <typename T> auto is_aligned(const T* ptr) noexcept
+{
+  return reinterpret_cast<std::uintptr_t>(ptr) % simd_alignment == 0u;
+}
+
+// Index-based evaluation of a contiguous source into `out`.  Unless `alignment` already
+// guarantees it, leading elements are evaluated one by one until `out` is aligned.  Then
+// whole blocks are computed into a local buffer (so that stores into `out` cannot alias
+// anything the expression reads) and the remaining elements are handled by a scalar tail.
+template <typename T, typename It>
+auto contiguous_evaluate(It first, std::size_t size, T* out,
+                         std::size_t alignment = alignof(T)) -> void
+{
+  auto i = std::size_t{};
+
+  if (alignment < simd_alignment)
+    for (; i < size && !is_aligned(out + i); ++i)
+      out[i] = static_cast<T>(first[i]);
+
+  T buffer[evaluation_block_size];
+  for (; i + evaluation_block_size <= size; i += evaluation_block_size)
+  {
+    for (std::size_t j = 0u; j < evaluation_block_size; ++j)
+      buffer[j] = static_cast<T>(first[i + j]);
+    std::copy_n(buffer, evaluation_block_size, out + i);
+  }
+
+  for (; i < size; ++i)
+    out[i] = static_cast<T>(first[i]);
+}
+
+// Strides of at least this many bytes put every element on its own cache line, which
+// the hardware prefetchers do not follow; the strided kernels prefetch ahead instead.
+constexpr std::size_t prefetch_min_stride = 64u;
+
+// Number of elements ahead of the current one that the strided kernels prefetch.
+constexpr std::size_t prefetch_distance = 16u;
+
+template <bool Write, typename T> auto prefetch(const T* address) noexcept -> void
+{
+#if defined(__GNUC__)
+  __builtin_prefetch(address, Write ? 1 : 0, 3);
+#else
+  static_cast<void>(address);
+#endif
+}
+
+// Sources of at least this many bytes are assumed not to fit in the caches: the gather
+// and scatter kernels prefetch the elements of the indices `prefetch_distance` ahead.
+constexpr std::size_t indirect_prefetch_bytes = std::size_t{1u} << 22;
+
+#ifdef __AVX2__
+
+// Gathers with the AVX2 gather instructions as many elements as fill whole registers and
+// returns how many were written.  Only floating-point elements with 64-bit or signed
+// 32-bit indices are handled; the other combinations return 0.  The masked forms are used
+// with an explicit zero source, which the unmasked ones leave undefined.
+template <typename T, typename Index>
+auto simd_gather(const T* data, const Index* indices, std::size_t size, T* out,
+                 bool ahead) -> std::size_t
+{
+  constexpr auto is_index64 = sizeof(Index) == 8u;
+  constexpr auto is_index32 = sizeof(Index) == 4u && std::is_signed_v<Index>;
+  constexpr auto is_supported = (std::is_same_v<T, double> || std::is_same_v<T, float>) &&
+                                (is_index64 || is_index32);
+  constexpr auto lanes = std::is_same_v<T, float> && is_index32 ? 8u : 4u;
+
+  auto i = std::size_t{};
+
+  if constexpr (is_supported)
+  {
+    for (; i + lanes <= size; i += lanes)
+    {
+      if (ahead && i + prefetch_distance + lanes <= size)
+        for (auto k = std::size_t{}; k < lanes; ++k)
+          prefetch<false>(data + indices[i + prefetch_distance + k]);
+
+      const auto* index = indices + i;
+      if constexpr (std::is_same_v<T, double> && is_index64)
+      {
+        const auto offsets = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(index));
+        const auto all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+        _mm256_storeu_pd(out + i, _mm256_mask_i64gather_pd(_mm256_setzero_pd(), data,
+                                                           offsets, all, 8));
+      }
+      else if constexpr (std::is_same_v<T, double>)
+      {
+        const auto offsets = _mm_loadu_si128(reinterpret_cast<const __m128i*>(index));
+        const auto all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+        _mm256_storeu_pd(out + i, _mm256_mask_i32gather_pd(_mm256_setzero_pd(), data,
+                                                           offsets, all, 8));
+      }
+      else if constexpr (is_index64)
+      {
+        const auto offsets = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(index));
+        const auto all = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        _mm_storeu_ps(out + i,
+                      _mm256_mask_i64gather_ps(_mm_setzero_ps(), data, offsets, all, 4));
+      }
+      else
+      {
+        const auto offsets = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(index));
+        const auto all = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        _mm256_storeu_ps(out + i, _mm256_mask_i32gather_ps(_mm256_setzero_ps(), data,
+                                                           offsets, all, 4));
+      }
+    }
+  }
+  return i;
+}
+
+#endif // __AVX2__
+
+// Whether the `size` elements accessed through `first` may overlap the `extent` elements
+// starting at `data`.  The elements accessed by iterators other than pointers and strided
+// iterators, e.g. those of expressions, are unknown, so they are assumed to.
+template <typename It, typename T>
+auto may_overlap(It first, std::size_t size, const T* data, std::size_t extent) -> bool
+{
+  const auto before = std::less<const void*>{};
+
+  if (size == 0u || extent == 0u)
+    return false;
+  else if constexpr (std::is_pointer_v<It>)
+    return before(first, data + extent) && before(data, first + size);
+  else if constexpr (is_strided_iterator<It>::value)
+  {
+    const auto* base = first.base();
+    const auto* last = base + (size - 1u) * first.stride() + 1u;
+    return before(base, data + extent) && before(data, last);
+  }
+  else
+    return true;
+}
+
+// Writes `data[indices[0]]`, ..., `data[indices[size - 1]]` to `out`.  With `ahead`, the
+// element `prefetch_distance` positions later is prefetched, which hides the latency of
+// random accesses to sources that do not fit in the caches.
+template <typename T, typename It, typename U>
+auto gather_n(const T* data, It indices, std::size_t size, U* out, bool ahead) -> void
+{
+  auto i = std::size_t{};
+
+#ifdef __AVX2__
+  if constexpr (std::is_pointer_v<It> && std::is_same_v<T, U>)
+    i = simd_gather(data, indices, size, out, ahead);
+#endif
+
+  for (; i < size; ++i)
+  {
+    if (ahead && i + prefetch_distance < size)
+      prefetch<false>(data + indices[static_cast<std::ptrdiff_t>(i + prefetch_distance)]);
+    out[i] = static_cast<U>(data[indices[static_cast<std::ptrdiff_t>(i)]]);
+  }
+}
+
+// Writes `first[0]`, ..., `first[size - 1]` to `data[indices[0]]`, ...,
+// `data[indices[size - 1]]`, in order, so the last of repeated indices wins.
+template <typename It, typename T, typename IndexIt>
+auto scatter_n(It first, std::size_t size, T* data, IndexIt indices, bool ahead) -> void
+{
+  for (auto i = std::size_t{}; i < size; ++i, ++first)
+  {
+    if (ahead && i + prefetch_distance < size)
+      prefetch<true>(data + indices[static_cast<std::ptrdiff_t>(i + prefetch_distance)]);
+    data[indices[static_cast<std::ptrdiff_t>(i)]] = *first;
+  }
+}
+
+// Writes `value` to `data[indices[0]]`, ..., `data[indices[size - 1]]`.
+template <typename U, typename T, typename IndexIt>
+auto scatter_fill_n(const U& value, std::size_t size, T* data, IndexIt indices, bool ahead)
+  -> void
+{
+  for (auto i = std::size_t{}; i < size; ++i)
+  {
+    if (ahead && i + prefetch_distance < size)
+      prefetch<true>(data + indices[static_cast<std::ptrdiff_t>(i + prefetch_distance)]);
+    data[indices[static_cast<std::ptrdiff_t>(i)]] = value;
+  }
+}
+
+// Calls `f(i)` for every `i` in [0, size), unrolled by four, where `f` accesses
+// `data[i * stride]`.  Large strides prefetch the elements `prefetch_distance` ahead.
+template <bool Write, typename T, typename F>
+auto strided_for_n(T* data, std::size_t stride, std::size_t size, F f) -> void
+{
+  auto i = std::size_t{};
+
+  if (stride * sizeof(T) >= prefetch_min_stride)
+  {
+    for (; i + prefetch_distance + 4u <= size; i += 4u)
+    {
+      for (std::size_t j = 0u; j < 4u; ++j)
+        prefetch<Write>(data + (i + prefetch_distance + j) * stride);
+      f(i);
+      f(i + 1u);
+      f(i + 2u);
+      f(i + 3u);
+    }
+  }
+
+  for (; i + 4u <= size; i += 4u)
+  {
+    f(i);
+    f(i + 1u);
+    f(i + 2u);
+    f(i + 3u);
+  }
+
+  for (; i < size; ++i)
+    f(i);
+}
+
+// Copies `size` elements `stride` apart into contiguous `out`.
+template <typename T, typename U>
+auto strided_gather(const T* data, std::size_t stride, std::size_t size, U* out) -> void
+{
+  strided_for_n<false>(data, stride, size,
+                       [=](std::size_t i) { out[i] = static_cast<U>(data[i * stride]); });
+}
+
+// Copies `size` contiguous elements into `out`, `stride` elements apart.
+template <typename T, typename U>
+auto strided_scatter(const T* first, std::size_t size, U* out, std::size_t stride) -> void
+{
+  strided_for_n<true>(out, stride, size,
+                      [=](std::size_t i) { out[i * stride] = static_cast<U>(first[i]); });
+}
+
+// Copies `size` elements `stride` apart into `out`, `out_stride` elements apart, in
+// order.  Small strides bump pointers instead of multiplying indices, which keeps the
+// loop as short as a hand-written one.
+template <typename T, typename U>
+auto strided_copy(const T* data, std::size_t stride, std::size_t size, U* out,
+                  std::size_t out_stride) -> void
+{
+  if (out_stride * sizeof(U) >= prefetch_min_stride)
+  {
+    strided_for_n<true>(out, out_stride, size, [=](std::size_t i) {
+      out[i * out_stride] = static_cast<U>(data[i * stride]);
+    });
+    return;
+  }
+
+  for (; size >= 4u; size -= 4u, data += 4u * stride, out += 4u * out_stride)
+  {
+    out[0] = static_cast<U>(data[0]);
+    out[out_stride] = static_cast<U>(data[stride]);
+    out[2u * out_stride] = static_cast<U>(data[2u * stride]);
+    out[3u * out_stride] = static_cast<U>(data[3u * stride]);
+  }
+  for (; size > 0u; --size, data += stride, out += out_stride)
+    *out = static_cast<U>(*data);
+}
+
+template <typename T, typename U>
+auto strided_fill(T* data, std::size_t stride, std::size_t size, const U& value) -> void
+{
+  strided_for_n<true>(data, stride, size,
+                      [=, &value](std::size_t i) { data[i * stride] = value; });
+}
+
+// Evaluates a random access source into strided storage: blocks are computed into a
+// local buffer, where the source vectorizes as in `contiguous_evaluate`, and scattered.
+template <typename T, typename It>
+auto strided_evaluate(It first, std::size_t size, T* out, std::size_t stride) -> void
+{
+  T buffer[evaluation_block_size];
+  for (auto i = std::size_t{}; i < size; i += evaluation_block_size)
+  {
+    const auto n = std::min(evaluation_block_size, size - i);
+    const auto block = first + static_cast<std::ptrdiff_t>(i);
+    for (std::size_t j = 0u; j < n; ++j)
+      buffer[j] = static_cast<T>(block[j]);
+    strided_scatter(buffer, n, out + i * stride, stride);
+  }
+}
+
+// Writes `size` elements starting at `first` into `out`.  Arithmetic sources whose leaves
+// are contiguous take the vectorized path when `out` is a pointer; strided sources and
+// destinations of arithmetic type go through the strided kernels, element to element
+// when both are strided.
+template <typename It, typename OutIt>
+auto evaluate_n(It first, std::size_t size, OutIt out, std::size_t alignment = 1u) -> void
+{
+  using source_type = typename std::iterator_traits<It>::value_type;
+  using target_type = typename std::iterator_traits<OutIt>::value_type;
+  constexpr auto is_arithmetic =
+    std::is_arithmetic_v<source_type> && std::is_arithmetic_v<target_type>;
+
+  if constexpr (is_vectorizable_iterator<OutIt, It>::value)
+    contiguous_evaluate(first, size, out, alignment);
+  else if constexpr (is_arithmetic && is_strided_iterator<It>::value &&
+                     std::is_pointer_v<OutIt>)
+    strided_gather(first.base(), first.stride(), size, out);
+  else if constexpr (is_arithmetic && is_strided_iterator<It>::value &&
+                     is_strided_iterator<OutIt>::value)
+    strided_copy(first.base(), first.stride(), size, out.base(), out.stride());
+  else if constexpr (is_arithmetic && is_strided_iterator<OutIt>::value &&
+                     is_random_access_iterator<It>::value)
+    strided_evaluate(first, size, out.base(), out.stride());
+  else
+    std::copy_n(first, size, out);
+}
+
+template <typename Vector, typename T, typename = void>
+struct has_evaluate_to : std::false_type
+{
+};
+
+template <typename Vector, typename T>
+struct has_evaluate_to<
+  Vector, T,
+  std::void_t<decltype(std::declval<const Vector&>().evaluate_to(std::declval<T*>()))>>
+  : std::true_type
+{
+};
+
+template <typename Vector, typename T, typename = void>
+struct has_assign_to : std::false_type
+{
+};
+
+template <typename Vector, typename T>
+struct has_assign_to<
+  Vector, T,
+  std::void_t<decltype(std::declval<const Vector&>().assign_to(std::declval<T*>()))>>
+  : std::true_type
+{
+};
+
+// Writes every element of `source` into `block`, which must hold `source.size()` elements.
+// Sources that know a faster way to write themselves than element by element, such as
+// concatenations of contiguous pieces, provide `evaluate_to(out)`.
+template <typename T, typename Vector>
+auto evaluate(const common_vector_base<Vector>& source, memory_block<T> block) -> void
+{
+  assert(source.size() == block.size());
+
+  if constexpr (has_evaluate_to<Vector, T>::value)
+    static_cast<const Vector&>(source).evaluate_to(block.data());
+  else
+    evaluate_n(source.begin(), source.size(), block.data(), block.alignment());
+}
+
+// Like `evaluate`, for a `block` that `source` may be a view of: when the elements of a
+// contiguous or strided source overlap `block`, they are copied as by `memmove`, either
+// directly or through a temporary, instead of by the blocked kernels.  Sources with an
+// `evaluate_to` hook provide `assign_to(out)` for the same purpose.  Other expressions
+// are still evaluated in place, so they may only read each element at the position they
+// assign.
+template <typename T, typename Vector>
+auto assign(const common_vector_base<Vector>& source, memory_block<T> block) -> void
+{
+  using iterator = const_iterator_t<Vector>;
+  using source_type = typename std::iterator_traits<iterator>::value_type;
+
+  if constexpr (has_assign_to<Vector, T>::value)
+  {
+    assert(source.size() == block.size());
+    static_cast<const Vector&>(source).assign_to(block.data());
+    return;
+  }
+  else if constexpr (std::is_pointer_v<iterator> || is_strided_iterator<iterator>::value)
+  {
+    if (may_overlap(source.begin(), source.size(), block.data(), block.size()))
+    {
+      if constexpr (std::is_pointer_v<iterator> && std::is_same_v<source_type, T> &&
+                    std::is_trivially_copyable_v<T>)
+        std::memmove(block.data(), source.begin(), source.size() * sizeof(T));
+      else
+      {
+        const auto copy = std::vector<T>(source.begin(), source.end());
+        std::copy(copy.begin(), copy.end(), block.data());
+      }
+      return;
+    }
+  }
+
+  evaluate(source, block);
+}
+
+// Number of truth values packed into one mask by the logical kernels.
+constexpr std::size_t mask_block_size = 64u;
+
+inline auto popcount(std::uint64_t mask) noexcept -> std::size_t
+{
+#if defined(__GNUC__)
+  return static_cast<std::size_t>(__builtin_popcountll(mask));
+#else
+  auto count = std::size_t{};
+  for (; mask != 0u; mask &= mask - 1u)
+    ++count;
+  return count;
+#endif
+}
+
+// Index of the lowest set bit of `mask`, which must not be zero.
+inline auto count_trailing_zeros(std::uint64_t mask) noexcept -> std::size_t
+{
+#if defined(__GNUC__)
+  return static_cast<std::size_t>(__builtin_ctzll(mask));
+#else
+  auto count = std::size_t{};
+  for (; (mask & 1u) == 0u; mask >>= 1u)
+    ++count;
+  return count;
+#endif
+}
+
+// Evaluates the truth value of `first[0]`, ..., `first[size - 1]` into the low `size`
+// bits of a mask, where `size <= mask_block_size`.  Truth values are first computed as
+// bytes, which vectorizes like any other element-wise kernel, and then packed eight at a
+// time with a multiplication that gathers the low bit of every byte.
+template <typename It> auto evaluate_mask(It first, std::size_t size) -> std::uint64_t
+{
+  unsigned char flags[mask_block_size];
+  if (size == mask_block_size)
+  {
+    for (std::size_t j = 0u; j < mask_block_size; ++j)
+      flags[j] = static_cast<bool>(first[j]);
+  }
+  else
+  {
+    std::fill(std::begin(flags), std::end(flags), 0u);
+    for (std::size_t j = 0u; j < size; ++j)
+      flags[j] = static_cast<bool>(first[j]);
+  }
+
+  auto mask = std::uint64_t{};
+  for (std::size_t k = 0u; k < mask_block_size / 8u; ++k)
+  {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    auto bytes = std::uint64_t{};
+    std::memcpy(&bytes, flags + 8u * k, 8u);
+    mask |= ((bytes * 0x0102040810204080u) >> 56) << (8u * k);
+#else
+    for (std::size_t j = 0u; j < 8u; ++j)
+      mask |= std::uint64_t{flags[8u * k + j]} << (8u * k + j);
+#endif
+  }
+  return mask;
+}
+
+// Calls `f(mask, n)` for consecutive blocks of `n <= mask_block_size` truth values of the
+// source, stopping as soon as `f` returns false.  Returns whether every block was visited.
+template <typename It, typename F>
+auto for_each_mask(It first, std::size_t size, F f) -> bool
+{
+  if constexpr (is_random_access_iterator<It>::value)
+  {
+    for (auto i = std::size_t{}; i < size; i += mask_block_size)
+    {
+      const auto n = std::min(mask_block_size, size - i);
+      if (!f(evaluate_mask(first + static_cast<std::ptrdiff_t>(i), n), n))
+        return false;
+    }
+  }
+  else
+  {
+    for (auto i = std::size_t{}; i < size; i += mask_block_size)
+    {
+      const auto n = std::min(mask_block_size, size - i);
+      auto mask = std::uint64_t{};
+      for (std::size_t j = 0u; j < n; ++j, ++first)
+        mask |= std::uint64_t{static_cast<bool>(*first)} << j;
+      if (!f(mask, n))
+        return false;
+    }
+  }
+  return true;
+}
+
+// Packs the truth values of `size` elements starting at `first` into `masks`, one bit per
+// element and `mask_block_size` elements per word, and returns how many are true.
+template <typename It>
+auto pack_mask(It first, std::size_t size, std::uint64_t* masks) -> std::size_t
+{
+  auto count = std::size_t{};
+  for_each_mask(first, size, [&](std::uint64_t mask, std::size_t) {
+    *masks++ = mask;
+    count += popcount(mask);
+    return true;
+  });
+  return count;
+}
+
+// Copies the elements of `first[0]`, ..., `first[size - 1]` whose bit is set in `masks`
+// to consecutive positions starting at `out`, and returns the end of the written range.
+// Full blocks are copied with the evaluation kernels; the others visit only their set
+// bits, so sparse masks cost little more than the scan of the mask itself.
+template <typename It, typename OutIt>
+auto compress_n(It first, std::size_t size, const std::uint64_t* masks, OutIt out) -> OutIt
+{
+  for (auto i = std::size_t{}; i < size; i += mask_block_size, ++masks)
+  {
+    const auto n = std::min(mask_block_size, size - i);
+    const auto block = first + static_cast<std::ptrdiff_t>(i);
+    auto mask = *masks;
+
+    if (n == mask_block_size && mask == ~std::uint64_t{})
+    {
+      if constexpr (std::is_pointer_v<OutIt>)
+      {
+        evaluate_n(block, n, out);
+        out += n;
+      }
+      else
+        out = std::copy_n(block, n, out);
+      continue;
+    }
+
+    for (; mask != 0u; mask &= mask - 1u)
+      *out++ = block[static_cast<std::ptrdiff_t>(count_trailing_zeros(mask))];
+  }
+  return out;
+}
+
+// Number of independent accumulators used by the reduction kernels.  Enough to fill
+// several vector registers so that additions do not wait on each other's latency.
+constexpr std::size_t reduction_lanes = 16u;
+
+// Folds `size` elements starting at `first` into `init` with `op`, which must be
+// associative and commutative.  Random access sources are reduced into independent
+// accumulators, seeded with the first elements so that no identity value is needed.
+template <typename R, typename It, typename Op>
+auto reduce_n(It first, std::size_t size, R init, Op op) -> R
+{
+  auto i = std::size_t{};
+
+  if constexpr (is_random_access_iterator<It>::value)
+  {
+    if (size >= reduction_lanes)
+    {
+      R acc[reduction_lanes];
+      for (std::size_t j = 0u; j < reduction_lanes; ++j)
+        acc[j] = static_cast<R>(first[j]);
+
+      for (i = reduction_lanes; i + reduction_lanes <= size; i += reduction_lanes)
+        for (std::size_t j = 0u; j < reduction_lanes; ++j)
+          acc[j] = op(acc[j], static_cast<R>(first[i + j]));
+
+      for (std::size_t j = 0u; j < reduction_lanes; ++j)
+        init = op(init, acc[j]);
+    }
+
+    for (; i < size; ++i)
+      init = op(init, static_cast<R>(first[i]));
+  }
+  else
+  {
+    for (; i < size; ++i, ++first)
+      init = op(init, static_cast<R>(*first));
+  }
+
+  return init;
+}
+
+// Recursive pairwise summation: error grows with the logarithm of the size instead of
+// linearly, at nearly the cost of the plain kernel.
+template <typename R, typename It> auto pairwise_sum_n(It first, std::size_t size) -> R
+{
+  constexpr auto base_size = 8u * reduction_lanes;
+
+  if (size <= base_size)
+    return reduce_n(first, size, R{}, std::plus<>{});
+
+  const auto half = size / 2u / reduction_lanes * reduction_lanes;
+  return pairwise_sum_n<R>(first, half) +
+         pairwise_sum_n<R>(first + static_cast<std::ptrdiff_t>(half), size - half);
+}
+
+// Kahan-Babuska (Neumaier) compensated summation, run over independent lanes.
+template <typename R, typename It> auto compensated_sum_n(It first, std::size_t size) -> R
+{
+  const auto add = [](R& sum, R& compensation, R value) {
+    const auto t = sum + value;
+    if (std::abs(sum) >= std::abs(value))
+      compensation += (sum - t) + value;
+    else
+      compensation += (value - t) + sum;
+    sum = t;
+  };
+
+  auto sum = R{}, compensation = R{};
+  auto i = std::size_t{};
+
+  if constexpr (is_random_access_iterator<It>::value)
+  {
+    R sums[reduction_lanes] = {}, compensations[reduction_lanes] = {};
+
+    for (; i + reduction_lanes <= size; i += reduction_lanes)
+      for (std::size_t j = 0u; j < reduction_lanes; ++j)
+        add(sums[j], compensations[j], static_cast<R>(first[i + j]));
+
+    for (std::size_t j = 0u; j < reduction_lanes; ++j)
+    {
+      add(sum, compensation, sums[j]);
+      compensation += compensations[j];
+    }
+
+    first += static_cast<std::ptrdiff_t>(i);
+  }
+
+  for (; i < size; ++i, ++first)
+    add(sum, compensation, static_cast<R>(*first));
+
+  return sum + compensation;
+}
+
+} // namespace vlite::detail
+
+#endif // VLITE_EVALUATION_HPP_INCLUDED
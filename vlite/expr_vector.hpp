@@ -1,13 +1,126 @@
 #ifndef VLITE_EXPR_VECTOR_HPP_INCLUDED
 #define VLITE_EXPR_VECTOR_HPP_INCLUDED
 
+#include <vlite/common_vector_base.hpp>
+#include <vlite/iterator_traits.hpp>
+
 #include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace vlite
 {
 
-template <typename Op> class expr_vector
+namespace detail
+{
+
+struct expression_node
+{
+};
+
+template <typename T> using is_expression_node = std::is_base_of<expression_node, T>;
+
+// Leaf that repeats a scalar at every index.  It is stored by value in its parent node, so
+// the evaluation kernels see a loop invariant they can keep in a register instead of a
+// closure to call for each element.
+template <typename T> class broadcast : public expression_node
+{
+public:
+  static constexpr bool is_contiguous = true;
+
+  constexpr explicit broadcast(T value)
+    : value_{std::move(value)}
+  {
+  }
+
+  constexpr auto compute(std::size_t) const noexcept -> const T& { return value_; }
+
+private:
+  T value_;
+};
+
+template <typename T> struct is_broadcast : std::false_type
+{
+};
+
+template <typename T> struct is_broadcast<broadcast<T>> : std::true_type
+{
+};
+
+// Leaf holding a copy of a vector whose iterators are not random access, which the nodes
+// could not index.  The elements are read once, when the expression is built, and shared
+// by the copies of the node.
+template <typename T> class materialized : public expression_node
+{
+public:
+  static constexpr bool is_contiguous = true;
+
+  template <typename It>
+  materialized(It first, It last)
+    : values_{std::make_shared<const std::vector<T>>(first, last)}
+    , data_{values_->data()}
+  {
+  }
+
+  auto begin() const noexcept -> const T* { return data_; }
+
+  auto compute(std::size_t i) const noexcept -> const T& { return data_[i]; }
+
+private:
+  std::shared_ptr<const std::vector<T>> values_;
+  const T* data_;
+};
+
+// Operands of an expression node: subexpressions are stored by value, so that a node owns
+// its whole tree and can outlive the statement that built it, and any other vector is
+// referenced by its begin iterator.  Vectors whose iterators are not random access are
+// copied instead.
+template <typename Vector> auto make_operand(const common_vector_base<Vector>& operand)
+{
+  if constexpr (is_expression_node<Vector>::value)
+    return static_cast<const Vector&>(operand);
+  else if constexpr (is_random_access_iterator<decltype(operand.begin())>::value)
+    return operand.begin();
+  else
+    return materialized<std::decay_t<typename Vector::value_type>>(operand.begin(),
+                                                                   operand.end());
+}
+
+// Scalar operands are broadcast to every index.
+template <typename T, typename = meta::fallback<CommonVector<T>>>
+auto make_operand(const T& value)
+{
+  return broadcast<T>{value};
+}
+
+template <typename Operand>
+constexpr decltype(auto) operand_at(const Operand& operand, std::size_t i)
+{
+  if constexpr (is_expression_node<Operand>::value)
+    return operand.compute(i);
+  else
+    return operand[static_cast<std::ptrdiff_t>(i)];
+}
+
+// Iterator to the first element of an operand.
+template <typename Operand> auto operand_begin(const Operand& operand)
+{
+  if constexpr (is_expression_node<Operand>::value)
+    return operand.begin();
+  else
+    return operand;
+}
+
+template <typename Operand>
+using operand_result_t =
+  decltype(operand_at(std::declval<const Operand&>(), std::size_t{}));
+
+} // namespace detail
+
+template <typename Op> class expr_vector : public detail::expression_node
 {
 public:
   using size_type = std::size_t;
@@ -20,12 +133,6 @@ public:
   {
   }
 
-  constexpr expr_vector(const expr_vector& source) = delete;
-  constexpr expr_vector(expr_vector&& source) noexcept = delete;
-
-  constexpr auto operator=(const expr_vector& source) -> expr_vector& = delete;
-  constexpr auto operator=(expr_vector&& source) noexcept -> expr_vector& = delete;
-
   constexpr auto size() const noexcept { return size_; }
 
 protected:
@@ -39,6 +146,120 @@ private:
   std::size_t size_;
 };
 
+// Iterator over an expression node: a pointer to the node and an index.  Its size and the
+// cost of advancing or comparing it do not depend on the depth of the expression; the
+// element at the index is computed by the node from its operands.  Elements are returned
+// by value, so `reference` is `value_type`: like a proxy iterator, it supports every
+// random access operation, but not the forward iterator guarantee that `*it` is an lvalue.
+template <typename Node> class expr_iterator
+{
+public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = typename Node::value_type;
+  using difference_type = std::ptrdiff_t;
+  using reference = value_type;
+  using pointer = void;
+
+  static constexpr bool is_contiguous = Node::is_contiguous;
+
+  constexpr expr_iterator() = default;
+
+  constexpr expr_iterator(const Node* node, difference_type index) noexcept
+    : node_{node}
+    , index_{index}
+  {
+  }
+
+  constexpr auto operator++() -> expr_iterator&
+  {
+    ++index_;
+    return *this;
+  }
+
+  constexpr auto operator++(int) -> expr_iterator
+  {
+    auto copy = *this;
+    ++(*this);
+    return copy;
+  }
+
+  constexpr auto operator--() -> expr_iterator&
+  {
+    --index_;
+    return *this;
+  }
+
+  constexpr auto operator--(int) -> expr_iterator
+  {
+    auto copy = *this;
+    --(*this);
+    return copy;
+  }
+
+  constexpr auto operator+=(difference_type n) -> expr_iterator&
+  {
+    index_ += n;
+    return *this;
+  }
+
+  constexpr auto operator-=(difference_type n) -> expr_iterator&
+  {
+    index_ -= n;
+    return *this;
+  }
+
+  constexpr auto operator+(difference_type n) const -> expr_iterator
+  {
+    return {node_, index_ + n};
+  }
+
+  friend constexpr auto operator+(difference_type n, const expr_iterator& it)
+    -> expr_iterator
+  {
+    return it + n;
+  }
+
+  constexpr auto operator-(difference_type n) const -> expr_iterator
+  {
+    return {node_, index_ - n};
+  }
+
+  constexpr auto operator-(const expr_iterator& other) const -> difference_type
+  {
+    return index_ - other.index_;
+  }
+
+  constexpr auto operator==(const expr_iterator& other) const
+  {
+    return index_ == other.index_;
+  }
+
+  constexpr auto operator!=(const expr_iterator& other) const { return !(*this == other); }
+
+  constexpr auto operator<(const expr_iterator& other) const
+  {
+    return index_ < other.index_;
+  }
+
+  constexpr auto operator>(const expr_iterator& other) const { return other < *this; }
+  constexpr auto operator<=(const expr_iterator& other) const { return !(other < *this); }
+  constexpr auto operator>=(const expr_iterator& other) const { return !(*this < other); }
+
+  constexpr auto operator*() const -> value_type
+  {
+    return node_->compute(static_cast<std::size_t>(index_));
+  }
+
+  constexpr auto operator[](difference_type n) const -> value_type
+  {
+    return node_->compute(static_cast<std::size_t>(index_ + n));
+  }
+
+private:
+  const Node* node_ = nullptr;
+  difference_type index_ = 0;
+};
+
 } // namespace vlite
 
 #endif // VLITE_EXPR_VECTOR_HPP_INCLUDED
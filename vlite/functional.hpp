@@ -2,27 +2,102 @@
 #define JULES_VECTOR_FUNCTIONAL_H
 
 #include <vlite/binary_expr_vector.hpp>
+#include <vlite/ternary_expr_vector.hpp>
 #include <vlite/unary_expr_vector.hpp>
 
+#include <cmath>
 #include <functional>
+#include <stdexcept>
+#include <type_traits>
 
 namespace vlite
 {
 
+namespace detail
+{
+
+template <typename VectorA, typename VectorB>
+auto check_sizes(const common_vector_base<VectorA>& lhs,
+                 const common_vector_base<VectorB>& rhs) -> void
+{
+  if (lhs.size() != rhs.size())
+    throw std::runtime_error{"sizes mismatch"};
+}
+
+} // namespace detail
+
 template <typename Vector, typename Op>
 static auto apply(const common_vector_base<Vector>& operand, Op op)
 {
-  return unary_expr_vector(operand.begin(), operand.end(), std::move(op), operand.size());
+  return unary_expr_vector(detail::make_operand(operand), std::move(op), operand.size());
 }
 
 template <typename VectorA, typename VectorB, typename Op>
 static auto apply(const common_vector_base<VectorA>& lhs,
                   const common_vector_base<VectorB>& rhs, Op op)
 {
-  return binary_expr_vector(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::move(op),
-                            lhs.size());
+  detail::check_sizes(lhs, rhs);
+  return binary_expr_vector(detail::make_operand(lhs), detail::make_operand(rhs),
+                            std::move(op), lhs.size());
 }
 
+namespace detail
+{
+
+// Whether std::fma is a single instruction for `T`, rather than a slow library call.
+template <typename T> inline constexpr bool has_fast_fma = false;
+
+#ifdef FP_FAST_FMAF
+template <> inline constexpr bool has_fast_fma<float> = true;
+#endif
+
+#ifdef FP_FAST_FMA
+template <> inline constexpr bool has_fast_fma<double> = true;
+#endif
+
+#ifdef FP_FAST_FMAL
+template <> inline constexpr bool has_fast_fma<long double> = true;
+#endif
+
+// `a * b + c`, with a single rounding when the three operands share a floating type that
+// the target multiplies and adds in one instruction.
+struct multiply_add
+{
+  template <typename A, typename B, typename C>
+  constexpr auto operator()(const A& a, const B& b, const C& c) const
+  {
+    if constexpr (std::is_same_v<A, B> && std::is_same_v<A, C> && has_fast_fma<A>)
+      return std::fma(a, b, c);
+    else
+      return a * b + c;
+  }
+};
+
+template <typename T> struct is_product : std::false_type
+{
+};
+
+template <typename Lhs, typename Rhs>
+struct is_product<binary_expr_vector<Lhs, Rhs, std::multiplies<>>> : std::true_type
+{
+};
+
+// Builds the node of a binary operator from its operands.  A sum with a product on either
+// side becomes a single multiply-add node, so `a * s + b` and `a * b + c` are evaluated
+// without an intermediate rounding or a nested call per element.
+template <typename Lhs, typename Rhs, typename Op>
+auto make_binary(Lhs lhs, Rhs rhs, Op op, std::size_t size)
+{
+  if constexpr (std::is_same_v<Op, std::plus<>> && is_product<Lhs>::value)
+    return ternary_expr_vector(lhs.lhs(), lhs.rhs(), std::move(rhs), multiply_add{}, size);
+  else if constexpr (std::is_same_v<Op, std::plus<>> && is_product<Rhs>::value)
+    return ternary_expr_vector(rhs.lhs(), rhs.rhs(), std::move(lhs), multiply_add{}, size);
+  else
+    return binary_expr_vector(std::move(lhs), std::move(rhs), std::move(op), size);
+}
+
+} // namespace detail
+
 #define OPERATIONS_LIST                                                                  \
   UNARY_OPERATIONS_LIST                                                                  \
   BINARY_OPERATIONS_LIST
@@ -52,25 +127,26 @@ static auto apply(const common_vector_base<VectorA>& lhs,
   auto operator OP__(const common_vector_base<VectorA>& lhs,                             \
                      const common_vector_base<VectorB>& rhs)                             \
   {                                                                                      \
-    return apply(lhs, rhs, (FUNCTOR__){});                                               \
+    detail::check_sizes(lhs, rhs);                                                       \
+    return detail::make_binary(detail::make_operand(lhs), detail::make_operand(rhs),     \
+                               FUNCTOR__{}, lhs.size());                                 \
   }
 
 #define BINARY_RIGHT_TYPE_OPERATION(OP__, FUNCTOR__)                                     \
   template <typename Vector, typename T, typename = meta::fallback<CommonVector<T>>>     \
   auto operator OP__(const common_vector_base<Vector>& lhs, T rhs)                       \
   {                                                                                      \
-    return apply(lhs, [ rhs = std::move(rhs), op = (FUNCTOR__){} ](auto&& value) {       \
-      return op(std::forward<decltype(value)>(value), rhs);                              \
-    });                                                                                  \
+    return detail::make_binary(detail::make_operand(lhs),                                \
+                               detail::broadcast<T>{std::move(rhs)}, FUNCTOR__{},        \
+                               lhs.size());                                              \
   }
 
 #define BINARY_LEFT_TYPE_OPERATION(OP__, FUNCTOR__)                                      \
   template <typename T, typename Vector, typename = meta::fallback<CommonVector<T>>>     \
   auto operator OP__(T lhs, const common_vector_base<Vector>& rhs)                       \
   {                                                                                      \
-    return apply(rhs, [ lhs = std::move(lhs), op = (FUNCTOR__){} ](auto&& value) {       \
-      return op(lhs, std::forward<decltype(value)>(value));                              \
-    });                                                                                  \
+    return detail::make_binary(detail::broadcast<T>{std::move(lhs)},                     \
+                               detail::make_operand(rhs), FUNCTOR__{}, rhs.size());      \
   }
 
 #define UNARY_OPERATIONS_LIST                                                            \
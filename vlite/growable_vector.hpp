@@ -0,0 +1,382 @@
+#ifndef VLITE_GROWABLE_VECTOR_HPP_INCLUDED
+#define VLITE_GROWABLE_VECTOR_HPP_INCLUDED
+
+#include <vlite/allocator.hpp>
+#include <vlite/evaluation.hpp>
+#include <vlite/meta.hpp>
+#include <vlite/ref_vector.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+namespace vlite
+{
+
+namespace detail
+{
+
+template <typename Allocator>
+using reallocate_t = decltype(std::declval<const Allocator&>().reallocate(
+  std::declval<typename Allocator::block_type>(), std::size_t{}));
+
+template <typename T, typename Allocator>
+constexpr auto is_reallocatable_v =
+  std::is_trivially_copyable_v<T> && meta::compiles<Allocator, reallocate_t>::value;
+
+} // namespace detail
+
+// Vector whose size changes after construction, for results whose size is not known up
+// front.  Storage grows geometrically; trivially copyable elements are moved with the
+// allocator's `reallocate`, which resizes huge page blocks with `mremap` and shrinks in
+// place, so a finished growable_vector converts to a `vector` without copying.
+template <typename T, typename Allocator = allocator<T>>
+class growable_vector : private Allocator, public ref_vector<T>
+{
+public:
+  using value_type = T;
+
+  using allocator_type = Allocator;
+
+  using iterator = value_type*;
+
+  using const_iterator = const value_type*;
+
+  using size_type = std::size_t;
+
+  using difference_type = std::ptrdiff_t;
+
+  explicit growable_vector(const Allocator& alloc = Allocator{}) noexcept
+    : Allocator{alloc}
+  {
+  }
+
+  explicit growable_vector(std::size_t size, const Allocator& alloc = Allocator{})
+    : growable_vector{alloc}
+  {
+    resize(size);
+  }
+
+  growable_vector(const value_type& value, std::size_t size,
+                  const Allocator& alloc = Allocator{})
+    : growable_vector{alloc}
+  {
+    resize(size, value);
+  }
+
+  template <typename Vector>
+  explicit growable_vector(const common_vector_base<Vector>& other,
+                           const Allocator& alloc = Allocator{})
+    : growable_vector{alloc}
+  {
+    static_assert(std::is_constructible_v<T, const typename Vector::value_type&>);
+
+    reserve(other.size());
+    const auto block =
+      memory_block<value_type>{data(), other.size(), this->block_.alignment()};
+
+    if constexpr (detail::is_vectorizable_v<value_type, Vector>)
+      detail::evaluate(other, block);
+    else
+      this->construct(block, other.begin());
+
+    this->block_ = block;
+  }
+
+  ~growable_vector() noexcept
+  {
+    this->destroy(this->block_);
+    this->deallocate(storage());
+  }
+
+  growable_vector(const growable_vector& source)
+    : growable_vector{source.get_allocator()}
+  {
+    assign(source);
+  }
+
+  growable_vector(growable_vector&& source) noexcept
+    : Allocator{source.get_allocator()}
+    , ref_vector<value_type>{std::exchange(source.block_, {})}
+    , capacity_{std::exchange(source.capacity_, 0u)}
+  {
+  }
+
+  auto operator=(const growable_vector& source) -> growable_vector&
+  {
+    if (this != &source)
+      assign(source);
+    return *this;
+  }
+
+  auto operator=(growable_vector&& source) noexcept -> growable_vector&
+  {
+    std::swap(this->block_, source.block_);
+    std::swap(capacity_, source.capacity_);
+    std::swap(static_cast<Allocator&>(*this), static_cast<Allocator&>(source));
+    return *this;
+  }
+
+  auto capacity() const noexcept { return capacity_; }
+
+  auto empty() const noexcept { return size() == 0u; }
+
+  auto reserve(std::size_t capacity) -> void
+  {
+    if (capacity > capacity_)
+      relocate(capacity);
+  }
+
+  auto push_back(const value_type& value) -> void { emplace_back(value); }
+
+  auto push_back(value_type&& value) -> void { emplace_back(std::move(value)); }
+
+  template <typename... Args> auto emplace_back(Args&&... args) -> value_type&
+  {
+    if (size() < capacity_)
+    {
+      ::new (static_cast<void*>(end())) value_type(std::forward<Args>(args)...);
+    }
+    else
+    {
+      // The arguments may refer to elements that are about to move.
+      auto value = value_type(std::forward<Args>(args)...);
+      relocate(grown_capacity(size() + 1u));
+      ::new (static_cast<void*>(end())) value_type(std::move(value));
+    }
+
+    set_size(size() + 1u);
+    return back();
+  }
+
+  auto pop_back() noexcept -> void
+  {
+    assert(!empty());
+    set_size(size() - 1u);
+    std::destroy_at(end());
+  }
+
+  auto resize(std::size_t size) -> void
+  {
+    if (size <= this->size())
+      return truncate(size);
+
+    reserve(grown_capacity(size));
+    this->construct({end(), size - this->size()});
+    set_size(size);
+  }
+
+  auto resize(std::size_t size, const value_type& value) -> void
+  {
+    if (size <= this->size())
+      return truncate(size);
+
+    if (size > capacity_)
+    {
+      auto copy = value;
+      relocate(grown_capacity(size));
+      this->construct({end(), size - this->size()}, copy);
+    }
+    else
+      this->construct({end(), size - this->size()}, value);
+
+    set_size(size);
+  }
+
+  auto clear() noexcept -> void { truncate(0u); }
+
+  // Gives back the unused capacity.  Trivially copyable elements stay where they are.
+  auto shrink_to_fit() -> void
+  {
+    if (capacity_ > size())
+      relocate(size());
+  }
+
+  auto back() -> value_type&
+  {
+    assert(!empty());
+    return data()[size() - 1u];
+  }
+
+  auto back() const -> const value_type&
+  {
+    assert(!empty());
+    return data()[size() - 1u];
+  }
+
+  auto get_allocator() const noexcept -> Allocator { return *this; }
+
+  // Hands the elements over to the caller, leaving the growable_vector empty.  The block
+  // holds exactly `size()` elements and must be released with `get_allocator()`.
+  auto release() -> memory_block<value_type>
+  {
+    shrink_to_fit();
+    capacity_ = 0u;
+    return std::exchange(this->block_, {});
+  }
+
+  auto data() noexcept -> value_type* { return this->block_.data(); }
+
+  auto data() const noexcept -> const value_type* { return this->block_.data(); }
+
+  using ref_vector<T>::size;
+  using ref_vector<T>::begin;
+  using ref_vector<T>::end;
+  using ref_vector<T>::cbegin;
+  using ref_vector<T>::cend;
+
+private:
+  auto storage() const noexcept -> memory_block<value_type>
+  {
+    return {this->block_.data(), capacity_, this->block_.alignment()};
+  }
+
+  auto set_size(std::size_t size) noexcept -> void
+  {
+    this->block_ = {this->block_.data(), size, this->block_.alignment()};
+  }
+
+  auto truncate(std::size_t size) noexcept -> void
+  {
+    this->destroy({data() + size, this->size() - size});
+    set_size(size);
+  }
+
+  auto grown_capacity(std::size_t size) const noexcept -> std::size_t
+  {
+    constexpr auto min_capacity =
+      std::max<std::size_t>(cache_line_size / sizeof(value_type), 1u);
+    return std::max({size, 2u * capacity_, min_capacity});
+  }
+
+  auto assign(const growable_vector& source) -> void
+  {
+    clear();
+    reserve(source.size());
+    std::uninitialized_copy_n(source.data(), source.size(), data());
+    set_size(source.size());
+  }
+
+  // Moves the elements to storage for `capacity >= size()` elements.
+  auto relocate(std::size_t capacity) -> void
+  {
+    assert(capacity >= size());
+
+    const auto size = this->size();
+    auto block = memory_block<value_type>{};
+
+    if (capacity == 0u)
+      this->deallocate(storage());
+    else if constexpr (detail::is_reallocatable_v<value_type, Allocator>)
+      block = this->reallocate(storage(), capacity);
+    else
+    {
+      block = this->allocate(capacity);
+      try
+      {
+        if constexpr (std::is_nothrow_move_constructible_v<value_type> ||
+                      !std::is_copy_constructible_v<value_type>)
+          std::uninitialized_move_n(data(), size, block.data());
+        else
+          std::uninitialized_copy_n(data(), size, block.data());
+      }
+      catch (...)
+      {
+        this->deallocate(block);
+        throw;
+      }
+
+      this->destroy(this->block_);
+      this->deallocate(storage());
+    }
+
+    this->block_ = {block.data(), size, block.alignment()};
+    capacity_ = capacity;
+  }
+
+  std::size_t capacity_ = 0u;
+};
+
+template <typename Vector>
+growable_vector(common_vector_base<Vector>)
+  ->growable_vector<std::decay_t<typename Vector::value_type>>;
+
+} // namespace vlite
+
+#ifdef DOCTEST_LIBRARY_INCLUDED
+
+#include <vlite/vector.hpp>
+
+#include <string>
+
+TEST_CASE("[growable_vector] Growing and converting to a vector")
+{
+  using namespace vlite;
+
+  auto a = growable_vector<int>{};
+  CHECK(a.empty());
+
+  for (auto i = 0; i < 1000; ++i)
+    a.push_back(i);
+
+  CHECK(a.size() == 1000u);
+  CHECK(a.capacity() >= 1000u);
+  CHECK(a[999] == 999);
+  CHECK(sum(a) == 499500);
+
+  a.resize(10u);
+  a.resize(20u, 7);
+  CHECK(a[9] == 9);
+  CHECK(a[10] == 7);
+  CHECK(a.back() == 7);
+
+  a.push_back(a[0]);
+  CHECK(a.back() == 0);
+
+  a += 1;
+  CHECK(a[0] == 1);
+
+  // Shrinking keeps the elements where they are, and so does the conversion.
+  const auto* data = a.data();
+  a.shrink_to_fit();
+  CHECK(a.capacity() == a.size());
+  CHECK(a.data() == data);
+
+  const auto b = vector(std::move(a));
+  CHECK(b.size() == 21u);
+  CHECK(b.data() == data);
+  CHECK(a.empty());
+
+  auto c = growable_vector(b * 2);
+  CHECK(c.size() == b.size());
+  CHECK(all(c == b * 2));
+
+  auto strings = growable_vector<std::string>{};
+  for (auto i = 0; i < 100; ++i)
+    strings.emplace_back(std::to_string(i));
+  strings.pop_back();
+
+  auto copy = strings;
+  CHECK(copy.size() == 99u);
+  CHECK(copy[42] == "42");
+  CHECK(vector(std::move(copy))[98] == "98");
+}
+
+TEST_CASE("[growable_vector] Huge page growth")
+{
+  using namespace vlite;
+
+  auto a = growable_vector<double, huge_page_allocator<double>>{};
+  a.resize(huge_page_size / sizeof(double), 1.0);
+  a.resize(3u * huge_page_size / sizeof(double), 2.0);
+  CHECK(a[0] == 1.0);
+  CHECK(a[a.size() - 1u] == 2.0);
+  CHECK(sum(a) == 5.0 * huge_page_size / sizeof(double));
+
+  const auto b = vector(std::move(a));
+  CHECK(b.size() == 3u * huge_page_size / sizeof(double));
+}
+
+#endif // DOCTEST_LIBRARY_INCLUDED
+
+#endif // VLITE_GROWABLE_VECTOR_HPP_INCLUDED
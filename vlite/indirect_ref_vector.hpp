@@ -0,0 +1,148 @@
+#ifndef VLITE_INDIRECT_REF_VECTOR_HPP_INCLUDED
+#define VLITE_INDIRECT_REF_VECTOR_HPP_INCLUDED
+
+#include <vlite/common_vector_base.hpp>
+#include <vlite/evaluation.hpp>
+#include <vlite/expr_vector.hpp>
+
+#include <cassert>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace vlite
+{
+
+// Elements of an array picked by a vector of indices, as returned by
+// `ref_vector::operator[]`: element `i` is `data[indices[i]]`.  Reading it is an
+// expression, which gathers straight into the destination when assigned to contiguous
+// storage; assigning to it scatters into the array.
+template <typename T, typename Indices>
+class indirect_ref_vector : public detail::expression_node,
+                            public common_vector_base<indirect_ref_vector<T, Indices>>
+{
+public:
+  using value_type = std::remove_cv_t<T>;
+
+  using size_type = std::size_t;
+
+  using difference_type = std::ptrdiff_t;
+
+  static constexpr bool is_contiguous = false;
+
+  using iterator = expr_iterator<indirect_ref_vector>;
+
+  using const_iterator = iterator;
+
+  indirect_ref_vector(T* data, std::size_t extent, Indices indices, std::size_t size)
+    : data_{data}
+    , extent_{extent}
+    , indices_{std::move(indices)}
+    , size_{size}
+  {
+  }
+
+  indirect_ref_vector(const indirect_ref_vector& source) = default;
+
+  // Assignment writes the elements of `source` through the indices, in order; the last
+  // of repeated indices wins.
+  auto operator=(const indirect_ref_vector& source) -> indirect_ref_vector&
+  {
+    return assign(source);
+  }
+
+  template <typename Vector>
+  auto operator=(const common_vector_base<Vector>& source) -> indirect_ref_vector&
+  {
+    return assign(source);
+  }
+
+  template <typename U, typename = meta::fallback<CommonVector<U>>>
+  auto operator=(const U& source) -> indirect_ref_vector&
+  {
+    static_assert(!std::is_const_v<T>, "assignment to a constant vector");
+    detail::scatter_fill_n(source, size(), data_, detail::operand_begin(indices_),
+                           is_large());
+    return *this;
+  }
+
+  auto begin() const -> const_iterator { return cbegin(); }
+  auto end() const -> const_iterator { return cend(); }
+
+  auto cbegin() const -> const_iterator { return {this, 0}; }
+  auto cend() const -> const_iterator
+  {
+    return {this, static_cast<difference_type>(size())};
+  }
+
+  auto operator[](size_type i) const -> const value_type&
+  {
+    assert(i < size());
+    return compute(i);
+  }
+
+  // Element at `i`, without bounds checks, for the iterators and the parent nodes.
+  auto compute(size_type i) const -> const value_type&
+  {
+    const auto index = static_cast<std::size_t>(detail::operand_at(indices_, i));
+    assert(index < extent_);
+    return data_[index];
+  }
+
+  auto size() const noexcept { return size_; }
+
+  // Gathers every element into `out`, through a temporary when `out` overlaps the array,
+  // e.g. to permute a vector in place.
+  template <typename U> auto evaluate_to(U* out) const -> void
+  {
+    const auto* data = static_cast<const value_type*>(data_);
+    const auto indices = detail::operand_begin(indices_);
+
+    if (detail::may_overlap(out, size(), data, extent_))
+    {
+      auto values = std::vector<U>(size());
+      detail::gather_n(data, indices, size(), values.data(), is_large());
+      std::move(values.begin(), values.end(), out);
+    }
+    else
+      detail::gather_n(data, indices, size(), out, is_large());
+  }
+
+private:
+  template <typename Vector>
+  auto assign(const common_vector_base<Vector>& source) -> indirect_ref_vector&
+  {
+    static_assert(!std::is_const_v<T>, "assignment to a constant vector");
+
+    if (source.size() != size())
+      throw std::runtime_error{"sizes mismatch"};
+
+    const auto indices = detail::operand_begin(indices_);
+
+    // The elements of the source are all read before any is written when it may read the
+    // array, e.g. to permute a vector in place.
+    if (detail::may_overlap(source.begin(), size(), data_, extent_))
+    {
+      const auto values = std::vector<value_type>(source.begin(), source.end());
+      detail::scatter_n(values.begin(), size(), data_, indices, is_large());
+    }
+    else
+      detail::scatter_n(source.begin(), size(), data_, indices, is_large());
+    return *this;
+  }
+
+  auto is_large() const noexcept
+  {
+    return extent_ * sizeof(value_type) >= detail::indirect_prefetch_bytes;
+  }
+
+  T* data_;
+  std::size_t extent_;
+  Indices indices_;
+  std::size_t size_;
+};
+
+} // namespace vlite
+
+#endif // VLITE_INDIRECT_REF_VECTOR_HPP_INCLUDED
@@ -0,0 +1,44 @@
+#ifndef VLITE_ITERATOR_TRAITS_HPP_INCLUDED
+#define VLITE_ITERATOR_TRAITS_HPP_INCLUDED
+
+#include <iterator>
+#include <type_traits>
+
+namespace vlite::detail
+{
+
+// An iterator is contiguous when it is a raw pointer or when it is an expression iterator
+// whose leaves are all raw pointers.  Such iterators can be evaluated with a plain
+// index-based loop that the compiler is able to vectorize.
+template <typename It, typename = void> struct is_contiguous_iterator : std::false_type
+{
+};
+
+template <typename T> struct is_contiguous_iterator<T*, void> : std::true_type
+{
+};
+
+template <typename It>
+struct is_contiguous_iterator<It, std::void_t<decltype(It::is_contiguous)>>
+  : std::bool_constant<It::is_contiguous>
+{
+};
+
+template <typename It>
+constexpr auto is_contiguous_iterator_v = is_contiguous_iterator<It>::value;
+
+template <typename It>
+using is_random_access_iterator =
+  std::is_base_of<std::random_access_iterator_tag,
+                  typename std::iterator_traits<It>::iterator_category>;
+
+// Category of an iterator that advances all of `Its` in lockstep: random access when
+// every one of them is, input otherwise.
+template <typename... Its>
+using common_iterator_category_t =
+  std::conditional_t<std::conjunction_v<is_random_access_iterator<Its>...>,
+                     std::random_access_iterator_tag, std::input_iterator_tag>;
+
+} // namespace vlite::detail
+
+#endif // VLITE_ITERATOR_TRAITS_HPP_INCLUDED
@@ -0,0 +1,328 @@
+#ifndef VLITE_MAPPED_VECTOR_HPP_INCLUDED
+#define VLITE_MAPPED_VECTOR_HPP_INCLUDED
+
+#include <vlite/ref_vector.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+// File mappings are implemented with the POSIX `open`/`mmap` interface only.
+#if !defined(__unix__) && !defined(__APPLE__)
+#error "vlite/mapped_vector.hpp requires a POSIX system"
+#endif
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace vlite
+{
+
+// Expected order of accesses to a mapping, forwarded to the kernel with `madvise`.
+enum class access_pattern
+{
+  normal,
+  sequential,
+  random
+};
+
+struct map_options
+{
+  // Offset, in bytes, of the first element in the file.
+  std::size_t offset = 0u;
+
+  // Number of elements to map; by default, the rest of the file.
+  std::size_t size = std::numeric_limits<std::size_t>::max();
+
+  // Whether writes through a mutable mapping reach the file (`MAP_SHARED`) or stay
+  // private to the process (`MAP_PRIVATE`, copy-on-write).
+  bool shared = true;
+
+  // Fault in every page up front (`MAP_POPULATE`), instead of on first access.
+  bool populate = false;
+
+  access_pattern pattern = access_pattern::normal;
+};
+
+// Vector whose elements are the contents of a file mapped with `mmap`, so that slicing
+// and expressions run directly on page cache memory without reading the file into a
+// buffer.  `mapped_vector<const T>` maps the file read-only; `mapped_vector<T>` maps it
+// for writing, shared with the file or copy-on-write according to the options.  The file
+// holds the raw bytes of the elements, which must be trivially copyable.
+template <typename T> class mapped_vector : public ref_vector<T>
+{
+  using element_type = std::remove_const_t<T>;
+
+  static_assert(std::is_trivially_copyable_v<element_type>,
+                "mapped elements must be trivially copyable");
+
+public:
+  using value_type = T;
+
+  using iterator = value_type*;
+
+  using const_iterator = const value_type*;
+
+  using size_type = std::size_t;
+
+  using difference_type = std::ptrdiff_t;
+
+  static constexpr bool is_writable = !std::is_const_v<T>;
+
+  mapped_vector() noexcept = default;
+
+  explicit mapped_vector(const std::string& path, const map_options& options = {})
+  {
+    const auto fd = open_file(path, is_writable && options.shared ? O_RDWR : O_RDONLY);
+
+    try
+    {
+      struct stat status = {};
+      if (::fstat(fd, &status) != 0)
+        throw std::system_error{errno, std::generic_category(), "fstat " + path};
+
+      const auto file_size = static_cast<std::size_t>(status.st_size);
+      if (options.offset > file_size || options.offset % alignof(element_type) != 0u)
+        throw std::runtime_error{"invalid offset for " + path};
+
+      const auto available = (file_size - options.offset) / sizeof(element_type);
+      const auto size = std::min(options.size, available);
+      if (options.size != std::numeric_limits<std::size_t>::max() && size != options.size)
+        throw std::runtime_error{"file too small: " + path};
+
+      map(fd, options.offset, size, options);
+    }
+    catch (...)
+    {
+      ::close(fd);
+      throw;
+    }
+
+    // The mapping keeps the file referenced.
+    ::close(fd);
+  }
+
+  // Creates, or truncates, the file at `path` to hold `size` elements and maps it for
+  // writing.  The elements start zeroed.
+  static auto create(const std::string& path, std::size_t size, map_options options = {})
+    -> mapped_vector
+  {
+    static_assert(is_writable, "cannot create a read-only mapping");
+
+    if (size > static_cast<std::size_t>(std::numeric_limits<off_t>::max()) /
+                 sizeof(element_type))
+      throw std::bad_array_new_length{};
+
+    const auto fd = open_file(path, O_RDWR | O_CREAT | O_TRUNC);
+    if (::ftruncate(fd, static_cast<off_t>(size * sizeof(element_type))) != 0)
+    {
+      const auto error = errno;
+      ::close(fd);
+      throw std::system_error{error, std::generic_category(), "ftruncate " + path};
+    }
+    ::close(fd);
+
+    options.offset = 0u;
+    options.size = size;
+    options.shared = true;
+    return mapped_vector{path, options};
+  }
+
+  ~mapped_vector() noexcept
+  {
+    if (mapping_)
+      ::munmap(mapping_, mapped_bytes_);
+  }
+
+  mapped_vector(const mapped_vector&) = delete;
+
+  mapped_vector(mapped_vector&& source) noexcept
+    : ref_vector<value_type>{std::exchange(source.block_, {})}
+    , mapping_{std::exchange(source.mapping_, nullptr)}
+    , mapped_bytes_{std::exchange(source.mapped_bytes_, 0u)}
+  {
+  }
+
+  auto operator=(const mapped_vector&) -> mapped_vector& = delete;
+
+  auto operator=(mapped_vector&& source) noexcept -> mapped_vector&
+  {
+    std::swap(this->block_, source.block_);
+    std::swap(mapping_, source.mapping_);
+    std::swap(mapped_bytes_, source.mapped_bytes_);
+    return *this;
+  }
+
+  template <typename Vector>
+  auto operator=(const common_vector_base<Vector>& source) -> mapped_vector&
+  {
+    ref_vector<T>::operator=(source);
+    return *this;
+  }
+
+  template <typename U, typename = meta::fallback<CommonVector<U>>>
+  auto operator=(const U& source) -> mapped_vector&
+  {
+    ref_vector<T>::operator=(source);
+    return *this;
+  }
+
+  // Changes the access pattern hint for the whole mapping.
+  auto advise(access_pattern pattern) const noexcept -> void
+  {
+    if (mapping_)
+      ::madvise(mapping_, mapped_bytes_, advice(pattern));
+  }
+
+  // Blocks until the changes made through a shared mapping are written to the file.
+  auto flush() const -> void
+  {
+    if (mapping_ && ::msync(mapping_, mapped_bytes_, MS_SYNC) != 0)
+      throw std::system_error{errno, std::generic_category(), "msync"};
+  }
+
+  auto data() noexcept -> value_type* { return this->block_.data(); }
+
+  auto data() const noexcept -> const value_type* { return this->block_.data(); }
+
+  using ref_vector<T>::size;
+  using ref_vector<T>::begin;
+  using ref_vector<T>::end;
+  using ref_vector<T>::cbegin;
+  using ref_vector<T>::cend;
+
+private:
+  static auto open_file(const std::string& path, int flags) -> int
+  {
+    const auto fd = ::open(path.c_str(), flags | O_CLOEXEC, 0644);
+    if (fd < 0)
+      throw std::system_error{errno, std::generic_category(), "open " + path};
+    return fd;
+  }
+
+  static auto advice(access_pattern pattern) noexcept -> int
+  {
+    switch (pattern)
+    {
+    case access_pattern::sequential:
+      return MADV_SEQUENTIAL;
+    case access_pattern::random:
+      return MADV_RANDOM;
+    default:
+      return MADV_NORMAL;
+    }
+  }
+
+  auto map(int fd, std::size_t offset, std::size_t size, const map_options& options)
+    -> void
+  {
+    if (size == 0u)
+      return;
+
+    // Mappings start at a page boundary; the elements start `head` bytes later.
+    const auto page_size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    const auto head = offset % page_size;
+
+    const auto protection = is_writable ? PROT_READ | PROT_WRITE : PROT_READ;
+    auto flags = is_writable && !options.shared ? MAP_PRIVATE : MAP_SHARED;
+#if defined(MAP_POPULATE)
+    if (options.populate)
+      flags |= MAP_POPULATE;
+#endif
+
+    const auto bytes = head + size * sizeof(element_type);
+    auto* mapping = ::mmap(nullptr, bytes, protection, flags, fd,
+                           static_cast<off_t>(offset - head));
+    if (mapping == MAP_FAILED)
+      throw std::system_error{errno, std::generic_category(), "mmap"};
+
+    mapping_ = mapping;
+    mapped_bytes_ = bytes;
+
+    if (options.pattern != access_pattern::normal)
+      advise(options.pattern);
+#if !defined(MAP_POPULATE)
+    if (options.populate)
+      ::madvise(mapping, bytes, MADV_WILLNEED);
+#endif
+
+    auto* data = static_cast<char*>(mapping) + head;
+    const auto address = reinterpret_cast<std::uintptr_t>(data);
+    const auto alignment = std::min<std::size_t>(address & (~address + 1u), page_size);
+    this->block_ = {reinterpret_cast<value_type*>(data), size, alignment};
+  }
+
+  void* mapping_ = nullptr;
+  std::size_t mapped_bytes_ = 0u;
+};
+
+} // namespace vlite
+
+#ifdef DOCTEST_LIBRARY_INCLUDED
+
+#include <vlite/vector.hpp>
+
+#include <cstdio>
+#include <filesystem>
+
+TEST_CASE("[mapped_vector] File-backed vectors")
+{
+  using namespace vlite;
+
+  const auto name = "vlite_mapped_vector_" + std::to_string(::getpid()) + ".bin";
+  const auto path = (std::filesystem::temp_directory_path() / name).string();
+  {
+    auto file = mapped_vector<float>::create(path, 1000u);
+    CHECK(file.size() == 1000u);
+    CHECK(all(file == 0.0f));
+
+    file = vector<float>(1.0f, 1000u) * 2.0f;
+    file[{0, 4}] = vector{1.0f, 2.0f, 3.0f, 4.0f};
+    file.flush();
+  }
+
+  {
+    const auto file = mapped_vector<const float>{path};
+    CHECK(file.size() == 1000u);
+    CHECK(sum(file) == 10.0f + 996u * 2.0f);
+    CHECK(reinterpret_cast<std::uintptr_t>(file.data()) % cache_line_size == 0u);
+
+    auto options = map_options{};
+    options.offset = 2u * sizeof(float);
+    options.size = 3u;
+    options.populate = true;
+    options.pattern = access_pattern::sequential;
+    const auto part = mapped_vector<const float>{path, options};
+    CHECK(all(part == vector{3.0f, 4.0f, 2.0f}));
+
+    options.size = 1000u;
+    CHECK_THROWS((mapped_vector<const float>{path, options}));
+  }
+
+  {
+    auto options = map_options{};
+    options.shared = false;
+    auto copy = mapped_vector<float>{path, options};
+    copy[every] = -1.0f;
+    CHECK(all(copy == -1.0f));
+
+    const auto file = mapped_vector<const float>{path};
+    CHECK(file[0] == 1.0f);
+  }
+
+  std::remove(path.c_str());
+  CHECK_THROWS(mapped_vector<const float>{path});
+}
+
+#endif // DOCTEST_LIBRARY_INCLUDED
+
+#endif // VLITE_MAPPED_VECTOR_HPP_INCLUDED
@@ -0,0 +1,190 @@
+#ifndef VLITE_MASKED_REF_VECTOR_HPP_INCLUDED
+#define VLITE_MASKED_REF_VECTOR_HPP_INCLUDED
+
+#include <vlite/builder.hpp>
+#include <vlite/common_vector_base.hpp>
+#include <vlite/evaluation.hpp>
+#include <vlite/expr_vector.hpp>
+#include <vlite/numeric.hpp>
+#include <vlite/parallel.hpp>
+#include <vlite/ref_vector.hpp>
+#include <vlite/ternary_expr_vector.hpp>
+
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace vlite
+{
+
+namespace detail
+{
+
+// `mask ? a : b`.  Arithmetic operands are both read before the choice, so that the loads
+// do not depend on the mask and the kernels evaluate it as a blend instead of a branch.
+struct select
+{
+  template <typename M, typename A, typename B>
+  constexpr auto operator()(const M& mask, const A& a, const B& b) const
+    -> std::common_type_t<A, B>
+  {
+    using result_type = std::common_type_t<A, B>;
+
+    if constexpr (std::is_arithmetic_v<result_type>)
+    {
+      const auto x = static_cast<result_type>(a);
+      const auto y = static_cast<result_type>(b);
+      return mask ? x : y;
+    }
+    else
+      return mask ? result_type(a) : result_type(b);
+  }
+};
+
+// Elements of `first[0]`, ..., `first[size - 1]` whose truth value in `mask` is set.  The
+// mask is evaluated once into a bit set whose popcount gives the exact size of the result,
+// and the elements are then copied in a single pass.  Large inputs are split into chunks
+// whose output offsets are the prefix sums of their counts, so that every chunk is packed
+// and compacted by its own thread.
+template <typename T, typename It, typename MaskIt>
+auto compress_n(It first, MaskIt mask, std::size_t size) -> vector<T>
+{
+  static_assert(parallel_chunk_size<T> % mask_block_size == 0u);
+
+  auto masks = std::vector<std::uint64_t>((size + mask_block_size - 1u) / mask_block_size);
+
+  if constexpr (!std::is_trivially_copyable_v<T> ||
+                !std::is_trivially_default_constructible_v<T>)
+  {
+    auto b = builder<T>(pack_mask(mask, size, masks.data()));
+    compress_n(first, size, masks.data(), std::back_inserter(b));
+    return vector<T>(std::move(b));
+  }
+  else
+  {
+    auto& pool = default_thread_pool();
+
+    if (size < parallel_threshold || pool.concurrency() == 1u)
+    {
+      auto b = builder<T>(pack_mask(mask, size, masks.data()));
+      compress_n(first, size, masks.data(), b.uninitialized().data());
+      b.commit(b.remaining());
+      return vector<T>(std::move(b));
+    }
+
+    constexpr auto chunk = parallel_chunk_size<T>;
+    const auto tasks = (size + chunk - 1u) / chunk;
+    auto offsets = std::vector<std::size_t>(tasks + 1u);
+
+    pool.run(tasks, [&](std::size_t i) {
+      const auto offset = i * chunk;
+      offsets[i + 1u] = pack_mask(mask + static_cast<std::ptrdiff_t>(offset),
+                                  std::min(chunk, size - offset),
+                                  masks.data() + offset / mask_block_size);
+    });
+
+    for (std::size_t i = 0u; i < tasks; ++i)
+      offsets[i + 1u] += offsets[i];
+
+    auto b = builder<T>(offsets.back());
+    auto* out = b.uninitialized().data();
+
+    pool.run(tasks, [&](std::size_t i) {
+      const auto offset = i * chunk;
+      compress_n(first + static_cast<std::ptrdiff_t>(offset),
+                 std::min(chunk, size - offset), masks.data() + offset / mask_block_size,
+                 out + offsets[i]);
+    });
+
+    b.commit(b.remaining());
+    return vector<T>(std::move(b));
+  }
+}
+
+} // namespace detail
+
+// Elements of `source` whose truth value in `mask` is set, in order.
+template <typename Vector, typename Mask>
+auto compress(const common_vector_base<Vector>& source,
+              const common_vector_base<Mask>& mask)
+{
+  if (source.size() != mask.size())
+    throw std::runtime_error{"sizes mismatch"};
+
+  using value_type = std::decay_t<typename Vector::value_type>;
+  return detail::compress_n<value_type>(source.begin(), mask.begin(), source.size());
+}
+
+// Lazy element-wise selection: `mask[i] ? a[i] : b[i]`, where `a` and `b` may also be
+// scalars.  Being an expression node, it is fused with the operators around it and
+// evaluated without branches.
+template <typename Mask, typename A, typename B>
+auto where(const common_vector_base<Mask>& mask, const A& a, const B& b)
+{
+  return ternary_expr_vector(detail::make_operand(mask), detail::make_operand(a),
+                             detail::make_operand(b), detail::select{}, mask.size());
+}
+
+// Elements of a ref_vector selected by a mask of the same size, as returned by
+// `ref_vector::operator[]`.  Assigning to it only changes the selected elements, in a
+// single branch-free pass; reading it compacts the selected elements into a vector.
+template <typename T, typename Mask> class masked_ref_vector
+{
+public:
+  using value_type = T;
+
+  masked_ref_vector(memory_block<T> target, Mask mask)
+    : target_{target}
+    , mask_{std::move(mask)}
+  {
+  }
+
+  // Assigns `source` to the selected elements: a scalar is written to every selected
+  // element, and a vector of the size of the target gives the element at each selected
+  // position.
+  template <typename U> auto operator=(const U& source) -> masked_ref_vector&
+  {
+    static_assert(!std::is_const_v<T>, "assignment to a constant vector");
+
+    if constexpr (CommonVector<U>::value)
+      if (source.size() != target_.size())
+        throw std::runtime_error{"sizes mismatch"};
+
+    auto target = ref_vector<T>{target_};
+    target = ternary_expr_vector(mask_, detail::make_operand(source),
+                                 detail::make_operand(target), detail::select{},
+                                 target.size());
+    return *this;
+  }
+
+  // Number of selected elements.
+  auto count() const -> std::size_t
+  {
+    auto result = std::size_t{};
+    const auto first = detail::operand_begin(mask_);
+    detail::for_each_mask(first, target_.size(), [&](std::uint64_t mask, std::size_t) {
+      result += detail::popcount(mask);
+      return true;
+    });
+    return result;
+  }
+
+  auto compact() const -> vector<std::remove_cv_t<T>>
+  {
+    return detail::compress_n<std::remove_cv_t<T>>(target_.begin(),
+                                                    detail::operand_begin(mask_),
+                                                    target_.size());
+  }
+
+  operator vector<std::remove_cv_t<T>>() const { return compact(); }
+
+private:
+  memory_block<T> target_;
+  Mask mask_;
+};
+
+} // namespace vlite
+
+#endif // VLITE_MASKED_REF_VECTOR_HPP_INCLUDED
@@ -13,15 +13,20 @@ public:
 
   constexpr memory_block() = default;
 
-  constexpr memory_block(value_type* data, std::size_t size)
+  constexpr memory_block(value_type* data, std::size_t size,
+                         std::size_t alignment = alignof(value_type))
     : data_{data}
     , size_{size}
+    , alignment_{alignment}
   {
   }
 
   constexpr auto data() const noexcept -> value_type* { return data_; }
   constexpr auto size() const noexcept -> std::size_t { return size_; }
 
+  // Alignment, in bytes, that `data()` is guaranteed to satisfy.
+  constexpr auto alignment() const noexcept -> std::size_t { return alignment_; }
+
   constexpr auto begin() noexcept { return data_; }
   constexpr auto end() noexcept { return data_ + size_; }
 
@@ -34,6 +39,7 @@ public:
 private:
   T* data_ = nullptr;
   std::size_t size_ = 0u;
+  std::size_t alignment_ = alignof(T);
 };
 } // namespace vlite
 
@@ -1,87 +1,218 @@
 #ifndef VLITE_NUMERIC_HPP_INCLUDED
 #define VLITE_NUMERIC_HPP_INCLUDED
 
-#include <vlite/builder.hpp>
+#include <vlite/allocator.hpp>
 #include <vlite/common_vector_base.hpp>
+#include <vlite/evaluation.hpp>
+#include <vlite/functional.hpp>
+
+#include <cmath>
+#include <stdexcept>
 
 namespace vlite
 {
 
-template <typename> class vector;
+template <typename T, typename Allocator = allocator<T>> class vector;
 
-namespace detail
+// The logical reductions evaluate their operand in blocks of 64 truth values packed into a
+// bit mask and stop at the first block that decides the result.
+
+template <typename Vector> auto all(const common_vector_base<Vector>& vec)
+{
+  const auto full = [](std::uint64_t mask, std::size_t n) {
+    return mask == (n == detail::mask_block_size ? ~std::uint64_t{}
+                                                 : (std::uint64_t{1u} << n) - 1u);
+  };
+  return detail::for_each_mask(vec.begin(), vec.size(), full);
+}
+
+template <typename Vector> auto any(const common_vector_base<Vector>& vec)
 {
+  return !none(vec);
+}
 
-template <typename T> struct cat_value_type
+template <typename Vector> auto none(const common_vector_base<Vector>& vec)
+{
+  return detail::for_each_mask(vec.begin(), vec.size(),
+                               [](std::uint64_t mask, std::size_t) { return mask == 0u; });
+}
+
+// Number of elements that evaluate to true.
+template <typename Vector> auto count(const common_vector_base<Vector>& vec) -> std::size_t
+{
+  auto result = std::size_t{};
+  detail::for_each_mask(vec.begin(), vec.size(), [&](std::uint64_t mask, std::size_t) {
+    result += detail::popcount(mask);
+    return true;
+  });
+  return result;
+}
+
+struct pairwise_t
 {
-  using type = std::decay_t<T>;
 };
 
-template <typename Vector> struct cat_value_type<common_vector_base<Vector>>
+static constexpr auto pairwise = pairwise_t{};
+
+struct compensated_t
 {
-  using type = typename Vector::value_type;
 };
 
-template <typename T> using cat_value_type_t = typename cat_value_type<T>::type;
+static constexpr auto compensated = compensated_t{};
+
+namespace detail
+{
 
 template <typename Vector>
-constexpr auto cat_size(const common_vector_base<Vector>& vec) noexcept -> std::size_t
+using sum_type_t = std::decay_t<decltype(std::declval<typename Vector::value_type>() +
+                                         std::declval<typename Vector::value_type>())>;
+
+struct minimum
+{
+  template <typename T> constexpr auto operator()(const T& a, const T& b) const -> T
+  {
+    return b < a ? b : a;
+  }
+};
+
+struct maximum
+{
+  template <typename T> constexpr auto operator()(const T& a, const T& b) const -> T
+  {
+    return a < b ? b : a;
+  }
+};
+
+struct absolute
 {
-  return vec.size();
+  template <typename T> constexpr auto operator()(const T& value) const
+  {
+    if constexpr (std::is_unsigned_v<T>)
+      return value;
+    else
+    {
+      using std::abs;
+      return abs(value);
+    }
+  }
+};
+
+template <typename Vector, typename Op>
+auto extremum(const common_vector_base<Vector>& vec, Op op)
+{
+  using R = std::decay_t<typename Vector::value_type>;
+
+  if (vec.size() == 0u)
+    throw std::runtime_error{"empty vector"};
+
+  const auto first = vec.begin();
+  return reduce_n(std::next(first), vec.size() - 1u, static_cast<R>(*first), op);
 }
 
-template <typename T> constexpr auto cat_size(const T&) noexcept -> std::size_t
+// Index of the first element equal to the extremum computed by the vectorized kernel.
+// Unordered values (NaN) fall back to a sequential scan with `compare`.
+template <typename Vector, typename Op, typename Compare>
+auto arg_extremum(const common_vector_base<Vector>& vec, Op op, Compare compare)
+  -> std::size_t
 {
-  return 1u;
+  const auto value = extremum(vec, op);
+
+  auto it = vec.begin();
+  for (std::size_t i = 0u; i < vec.size(); ++i, ++it)
+    if (*it == value)
+      return i;
+
+  it = vec.begin();
+  auto best = *it;
+  auto index = std::size_t{};
+  for (std::size_t i = 0u; i < vec.size(); ++i, ++it)
+  {
+    if (compare(*it, best))
+    {
+      best = *it;
+      index = i;
+    }
+  }
+  return index;
 }
 
-template <typename T, typename Vector>
-auto cat_push(builder<T>& b, const common_vector_base<Vector>& vec)
+} // namespace detail
+
+// Sum of the elements, accumulated in several independent lanes.  Small integer types are
+// promoted as by the built-in `+`.
+template <typename Vector> auto sum(const common_vector_base<Vector>& vec)
 {
-  std::copy(vec.begin(), vec.end(), std::back_inserter(b));
+  using R = detail::sum_type_t<Vector>;
+  return detail::reduce_n(vec.begin(), vec.size(), R{}, std::plus<>{});
 }
 
-template <typename T, typename U> auto cat_push(builder<T>& builder, U&& value)
+// Pairwise summation, with an error bound logarithmic in the size.
+template <typename Vector> auto sum(const common_vector_base<Vector>& vec, pairwise_t)
 {
-  builder.push_back(std::forward<U>(value));
+  return detail::pairwise_sum_n<detail::sum_type_t<Vector>>(vec.begin(), vec.size());
 }
 
-} // namespace detail
+// Compensated summation, with an error bound independent of the size.
+template <typename Vector> auto sum(const common_vector_base<Vector>& vec, compensated_t)
+{
+  return detail::compensated_sum_n<detail::sum_type_t<Vector>>(vec.begin(), vec.size());
+}
+
+template <typename Vector> auto prod(const common_vector_base<Vector>& vec)
+{
+  using R = detail::sum_type_t<Vector>;
+  return detail::reduce_n(vec.begin(), vec.size(), R{1}, std::multiplies<>{});
+}
 
-template <typename... Args> auto cat(Args&&... args)
+template <typename Vector> auto min(const common_vector_base<Vector>& vec)
 {
-  using R = std::common_type_t<detail::cat_value_type_t<Args>...>;
-  const auto size = (std::size_t{} + ... + detail::cat_size(args));
+  return detail::extremum(vec, detail::minimum{});
+}
 
-  auto b = builder<R>(size);
+template <typename Vector> auto max(const common_vector_base<Vector>& vec)
+{
+  return detail::extremum(vec, detail::maximum{});
+}
 
-  (detail::cat_push(b, std::forward<Args>(args)), ...);
+// Index of the first smallest element.
+template <typename Vector> auto argmin(const common_vector_base<Vector>& vec)
+{
+  return detail::arg_extremum(vec, detail::minimum{}, std::less<>{});
+}
 
-  return vector<R>(std::move(b));
+// Index of the first largest element.
+template <typename Vector> auto argmax(const common_vector_base<Vector>& vec)
+{
+  return detail::arg_extremum(vec, detail::maximum{}, std::greater<>{});
 }
 
-template <typename Vector> auto all(const common_vector_base<Vector>& vec)
+// Inner product, fused: the element-wise product is never materialized.
+template <typename VectorA, typename VectorB>
+auto dot(const common_vector_base<VectorA>& lhs, const common_vector_base<VectorB>& rhs)
 {
-  for (const auto& value : vec)
-    if (!value)
-      return false;
-  return true;
+  if (lhs.size() != rhs.size())
+    throw std::runtime_error{"sizes mismatch"};
+
+  return sum(apply(lhs, rhs, std::multiplies<>{}));
 }
 
-template <typename Vector> auto any(const common_vector_base<Vector>& vec)
+template <typename Vector> auto norm1(const common_vector_base<Vector>& vec)
 {
-  for (const auto& value : vec)
-    if (value)
-      return true;
-  return false;
+  return sum(apply(vec, detail::absolute{}));
 }
 
-template <typename Vector> auto none(const common_vector_base<Vector>& vec)
+// Euclidean norm.
+template <typename Vector> auto norm(const common_vector_base<Vector>& vec)
+{
+  using std::sqrt;
+  return sqrt(dot(vec, vec));
+}
+
+template <typename Vector> auto norm_inf(const common_vector_base<Vector>& vec)
 {
-  for (const auto& value : vec)
-    if (value)
-      return false;
-  return true;
+  const auto abs = apply(vec, detail::absolute{});
+  using R = typename decltype(abs)::value_type;
+  return vec.size() == 0u ? R{} : max(abs);
 }
 
 } // namespace vlite
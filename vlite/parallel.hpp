@@ -0,0 +1,343 @@
+#ifndef VLITE_PARALLEL_HPP_INCLUDED
+#define VLITE_PARALLEL_HPP_INCLUDED
+
+#include <vlite/common_vector_base.hpp>
+#include <vlite/evaluation.hpp>
+#include <vlite/expr_vector.hpp>
+#include <vlite/iterator_traits.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace vlite
+{
+
+// Below this number of elements, parallel evaluation falls back to the calling thread.
+constexpr std::size_t parallel_threshold = std::size_t{1u} << 18;
+
+namespace detail
+{
+
+// Fixed set of workers that execute indexed tasks together with the calling thread.
+class thread_pool
+{
+public:
+  explicit thread_pool(std::size_t workers)
+  {
+    workers_.reserve(workers);
+    try
+    {
+      for (std::size_t i = 0u; i < workers; ++i)
+        workers_.emplace_back([this] { work(); });
+    }
+    catch (...)
+    {
+      // Destroying a joinable thread terminates, so the workers started so far must be
+      // stopped before the exception leaves the constructor.
+      shutdown();
+      throw;
+    }
+  }
+
+  ~thread_pool() { shutdown(); }
+
+  thread_pool(const thread_pool&) = delete;
+  thread_pool(thread_pool&&) = delete;
+
+  auto operator=(const thread_pool&) -> thread_pool& = delete;
+  auto operator=(thread_pool&&) -> thread_pool& = delete;
+
+  // Number of threads that take part in `run`, including the caller.
+  auto concurrency() const noexcept { return workers_.size() + 1u; }
+
+  // Calls `f(i)` for every `i` in [0, count) and blocks until all calls have returned.
+  // The first exception thrown by a task is rethrown on the calling thread.
+  template <typename F> auto run(std::size_t count, F f) -> void
+  {
+    if (count <= 1u || workers_.empty() || inside_worker())
+    {
+      for (std::size_t i = 0u; i < count; ++i)
+        f(i);
+      return;
+    }
+
+    auto serial = std::lock_guard<std::mutex>{run_mutex_};
+
+    auto current = job{count, [](void* fn, std::size_t i) { (*static_cast<F*>(fn))(i); },
+                       static_cast<void*>(&f)};
+
+    {
+      auto lock = std::lock_guard<std::mutex>{mutex_};
+      job_ = &current;
+      ++generation_;
+    }
+    wake_.notify_all();
+
+    {
+      // Tasks run by the caller may call `run` again, like those run by the workers: the
+      // nested call then runs inline instead of waiting for `run_mutex_`.
+      auto inside = worker_scope{};
+      execute(current);
+    }
+
+    {
+      auto lock = std::unique_lock<std::mutex>{mutex_};
+      job_ = nullptr;
+      done_.wait(lock, [&] { return current.active == 0u; });
+    }
+
+    if (current.error)
+      std::rethrow_exception(current.error);
+  }
+
+private:
+  auto shutdown() noexcept -> void
+  {
+    {
+      auto lock = std::lock_guard<std::mutex>{mutex_};
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_)
+      worker.join();
+  }
+
+  struct job
+  {
+    job(std::size_t count, void (*invoke)(void*, std::size_t), void* fn)
+      : count{count}
+      , invoke{invoke}
+      , fn{fn}
+    {
+    }
+
+    std::size_t count;
+    void (*invoke)(void*, std::size_t);
+    void* fn;
+    std::atomic<std::size_t> next{0u};
+    std::size_t active = 0u;
+    std::exception_ptr error;
+    std::mutex error_mutex;
+  };
+
+  static auto inside_worker() noexcept -> bool&
+  {
+    thread_local auto flag = false;
+    return flag;
+  }
+
+  // Marks the current thread as executing tasks until the end of the scope.
+  class worker_scope
+  {
+  public:
+    worker_scope() noexcept
+      : previous_{std::exchange(inside_worker(), true)}
+    {
+    }
+
+    worker_scope(const worker_scope&) = delete;
+    auto operator=(const worker_scope&) -> worker_scope& = delete;
+
+    ~worker_scope() { inside_worker() = previous_; }
+
+  private:
+    bool previous_;
+  };
+
+  auto execute(job& current) -> void
+  {
+    for (auto i = current.next++; i < current.count; i = current.next++)
+    {
+      try
+      {
+        current.invoke(current.fn, i);
+      }
+      catch (...)
+      {
+        auto lock = std::lock_guard<std::mutex>{current.error_mutex};
+        if (!current.error)
+          current.error = std::current_exception();
+      }
+    }
+  }
+
+  auto work() -> void
+  {
+    inside_worker() = true;
+
+    auto seen = std::size_t{};
+    auto lock = std::unique_lock<std::mutex>{mutex_};
+
+    while (true)
+    {
+      wake_.wait(lock, [&] { return stop_ || (job_ && generation_ != seen); });
+      if (stop_)
+        return;
+
+      seen = generation_;
+      auto& current = *job_;
+      ++current.active;
+
+      lock.unlock();
+      execute(current);
+      lock.lock();
+
+      if (--current.active == 0u)
+        done_.notify_all();
+    }
+  }
+
+  std::vector<std::thread> workers_;
+
+  std::mutex run_mutex_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+
+  job* job_ = nullptr;
+  std::size_t generation_ = 0u;
+  bool stop_ = false;
+};
+
+inline auto default_thread_pool() -> thread_pool&
+{
+  static auto pool = thread_pool{std::max(std::thread::hardware_concurrency(), 1u) - 1u};
+  return pool;
+}
+
+// Elements per task: roughly what fits in a private L2 cache, in whole evaluation blocks so
+// that every chunk starts as aligned as the destination.
+template <typename T>
+constexpr std::size_t parallel_chunk_size = std::max<std::size_t>(
+  (std::size_t{1u} << 18) / sizeof(T) / evaluation_block_size * evaluation_block_size,
+  evaluation_block_size);
+
+// Copies larger than this many bytes are split across the default thread pool: a single
+// core cannot saturate the memory bandwidth of the machine.
+constexpr std::size_t parallel_copy_bytes = std::size_t{1u} << 24;
+
+template <typename T> auto parallel_copy_n(const T* first, std::size_t size, T* out) -> void
+{
+  static_assert(std::is_trivially_copyable_v<T>);
+
+  auto& pool = default_thread_pool();
+
+  if (size * sizeof(T) < parallel_copy_bytes || pool.concurrency() == 1u)
+  {
+    if (size > 0u)
+      std::memcpy(out, first, size * sizeof(T));
+    return;
+  }
+
+  constexpr auto chunk = parallel_chunk_size<T>;
+  pool.run((size + chunk - 1u) / chunk, [&](std::size_t i) {
+    const auto offset = i * chunk;
+    std::memcpy(out + offset, first + offset, std::min(chunk, size - offset) * sizeof(T));
+  });
+}
+
+} // namespace detail
+
+// Marks `source` to be evaluated by multiple threads when assigned to a vector.  Like the
+// expression nodes, it owns the subexpressions of `source` and references other vectors.
+template <typename Vector> class parallel_source
+{
+public:
+  using value_type = typename Vector::value_type;
+
+  parallel_source(const common_vector_base<Vector>& source, std::size_t threshold)
+    : source_{detail::make_operand(source)}
+    , size_{source.size()}
+    , threshold_{threshold}
+  {
+  }
+
+  auto size() const noexcept { return size_; }
+
+  auto begin() const { return detail::operand_begin(source_); }
+
+  // Writes every element of the source into `out`, splitting the work in chunks across the
+  // default thread pool when the source is large enough.  `alignment` is the alignment
+  // `out` is known to satisfy; chunk boundaries preserve it.
+  template <typename OutIt>
+  auto evaluate(OutIt out, std::size_t alignment = 1u) const -> void
+  {
+    const auto first = begin();
+    const auto size = size_;
+
+    auto& pool = detail::default_thread_pool();
+
+    if (size < threshold_ || pool.concurrency() == 1u)
+    {
+      detail::evaluate_n(first, size, out, alignment);
+      return;
+    }
+
+    constexpr auto chunk = detail::parallel_chunk_size<value_type>;
+    pool.run((size + chunk - 1u) / chunk, [&](std::size_t i) {
+      const auto offset = i * chunk;
+      const auto n = std::min(chunk, size - offset);
+      const auto diff = static_cast<std::ptrdiff_t>(offset);
+      detail::evaluate_n(first + diff, n, out + diff, alignment);
+    });
+  }
+
+private:
+  using operand_type =
+    decltype(detail::make_operand(std::declval<const common_vector_base<Vector>&>()));
+
+  operand_type source_;
+  std::size_t size_;
+  std::size_t threshold_;
+};
+
+// Wraps `source` so that assigning it to a ref_vector, strided_ref_vector or vector splits
+// the evaluation across threads.  Sources smaller than `threshold` are evaluated on the
+// calling thread.
+template <typename Vector>
+auto parallel(const common_vector_base<Vector>& source,
+              std::size_t threshold = parallel_threshold)
+{
+  static_assert(detail::is_random_access_iterator<detail::const_iterator_t<Vector>>::value,
+                "parallel evaluation requires random access");
+  return parallel_source<Vector>{source, threshold};
+}
+
+} // namespace vlite
+
+#ifdef DOCTEST_LIBRARY_INCLUDED
+
+TEST_CASE("[parallel] Thread pool")
+{
+  auto pool = vlite::detail::thread_pool{3u};
+  CHECK(pool.concurrency() == 4u);
+
+  for (const auto count : {0u, 1u, 7u, 1000u})
+  {
+    auto hits = std::vector<std::atomic<int>>(count);
+    pool.run(count, [&](std::size_t i) { ++hits[i]; });
+    CHECK(std::all_of(hits.begin(), hits.end(), [](const auto& h) { return h == 1; }));
+  }
+
+  auto nested = std::vector<std::atomic<int>>(64u * 4u);
+  pool.run(64u, [&](std::size_t i) {
+    pool.run(4u, [&](std::size_t j) { ++nested[4u * i + j]; });
+  });
+  CHECK(std::all_of(nested.begin(), nested.end(), [](const auto& h) { return h == 1; }));
+
+  CHECK_THROWS(pool.run(10u, [](std::size_t i) {
+    if (i == 5u)
+      throw std::runtime_error{"task failed"};
+  }));
+}
+
+#endif // DOCTEST_LIBRARY_INCLUDED
+
+#endif // VLITE_PARALLEL_HPP_INCLUDED
@@ -0,0 +1,269 @@
+#ifndef VLITE_POOL_HPP_INCLUDED
+#define VLITE_POOL_HPP_INCLUDED
+
+#include <vlite/allocator.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <new>
+
+namespace vlite
+{
+
+struct pool_statistics
+{
+  std::size_t hits;          // allocations served from the cache
+  std::size_t misses;        // allocations that reached operator new
+  std::size_t cached_blocks; // blocks currently held by the cache
+  std::size_t cached_bytes;  // bytes currently held by the cache
+};
+
+namespace detail
+{
+
+// Per-thread cache of freed buffers, bucketed by power-of-two size classes.  Blocks larger
+// than the biggest class, or that would make the cache exceed its limit, are returned to
+// the system immediately.
+class buffer_pool
+{
+public:
+  static constexpr std::size_t min_class_bytes = cache_line_size;
+  static constexpr std::size_t class_count = 21u; // 64 B up to 64 MiB
+  static constexpr std::size_t max_class_bytes = min_class_bytes << (class_count - 1u);
+  static constexpr std::size_t default_limit = std::size_t{1u} << 28;
+
+  buffer_pool() noexcept = default;
+
+  ~buffer_pool()
+  {
+    trim(0u);
+    destroyed() = true;
+  }
+
+  buffer_pool(const buffer_pool&) = delete;
+  buffer_pool(buffer_pool&&) = delete;
+
+  auto operator=(const buffer_pool&) -> buffer_pool& = delete;
+  auto operator=(buffer_pool&&) -> buffer_pool& = delete;
+
+  // Pool of the calling thread, or null while the thread is being torn down.
+  static auto local() noexcept -> buffer_pool*
+  {
+    if (destroyed())
+      return nullptr;
+    thread_local buffer_pool pool;
+    return &pool;
+  }
+
+  static constexpr auto size_class(std::size_t bytes) noexcept -> std::size_t
+  {
+    auto index = std::size_t{};
+    while ((min_class_bytes << index) < bytes)
+      ++index;
+    return index;
+  }
+
+  static constexpr auto class_bytes(std::size_t index) noexcept -> std::size_t
+  {
+    return min_class_bytes << index;
+  }
+
+  auto allocate(std::size_t index) -> void*
+  {
+    if (auto* node = free_[index])
+    {
+      free_[index] = node->next;
+      --stats_.cached_blocks;
+      stats_.cached_bytes -= class_bytes(index);
+      ++stats_.hits;
+      return node;
+    }
+
+    ++stats_.misses;
+    return ::operator new(class_bytes(index), std::align_val_t{cache_line_size});
+  }
+
+  auto deallocate(void* data, std::size_t index) noexcept -> void
+  {
+    if (stats_.cached_bytes + class_bytes(index) > limit_)
+    {
+      ::operator delete(data, std::align_val_t{cache_line_size});
+      return;
+    }
+
+    free_[index] = ::new (data) node_type{free_[index]};
+    ++stats_.cached_blocks;
+    stats_.cached_bytes += class_bytes(index);
+  }
+
+  // Frees cached blocks, largest first, until at most `bytes` bytes remain cached.
+  auto trim(std::size_t bytes) noexcept -> void
+  {
+    for (auto index = class_count; index-- > 0u && stats_.cached_bytes > bytes;)
+    {
+      while (free_[index] && stats_.cached_bytes > bytes)
+      {
+        auto* node = free_[index];
+        free_[index] = node->next;
+        --stats_.cached_blocks;
+        stats_.cached_bytes -= class_bytes(index);
+        ::operator delete(node, std::align_val_t{cache_line_size});
+      }
+    }
+  }
+
+  auto statistics() const noexcept { return stats_; }
+
+  auto limit() const noexcept { return limit_; }
+
+  auto set_limit(std::size_t bytes) noexcept -> void
+  {
+    limit_ = bytes;
+    trim(bytes);
+  }
+
+private:
+  struct node_type
+  {
+    node_type* next;
+  };
+
+  static auto destroyed() noexcept -> bool&
+  {
+    thread_local auto flag = false;
+    return flag;
+  }
+
+  std::array<node_type*, class_count> free_ = {};
+  pool_statistics stats_ = {};
+  std::size_t limit_ = default_limit;
+};
+
+} // namespace detail
+
+// Allocator that recycles blocks through a thread-local cache, so that loops building and
+// dropping vectors of recurring sizes stop reaching the system allocator once warm.  The
+// cache of each thread holds at most `pool_limit()` bytes.
+template <typename T> struct pool_allocator : allocator<T>
+{
+  using typename allocator<T>::value_type;
+  using typename allocator<T>::block_type;
+
+  static_assert(alignof(value_type) <= cache_line_size, "over-aligned type");
+
+  auto allocate(std::size_t size) const -> block_type
+  {
+    if (size > detail::buffer_pool::max_class_bytes / sizeof(value_type))
+      return allocator<T>::allocate(size);
+
+    auto* pool = detail::buffer_pool::local();
+    if (!pool)
+      return allocator<T>::allocate(size);
+
+    const auto index = detail::buffer_pool::size_class(size * sizeof(value_type));
+    return {static_cast<value_type*>(pool->allocate(index)), size, cache_line_size};
+  }
+
+  auto deallocate(block_type block) const noexcept -> void
+  {
+    auto* pool = detail::buffer_pool::local();
+    if (!block.data() || !pool ||
+        block.size() > detail::buffer_pool::max_class_bytes / sizeof(value_type))
+    {
+      allocator<T>::deallocate(block);
+      return;
+    }
+
+    const auto index = detail::buffer_pool::size_class(block.size() * sizeof(value_type));
+    pool->deallocate(block.data(), index);
+  }
+
+  // Blocks that stay in the same size class are resized in place.
+  auto reallocate(block_type block, std::size_t size) const -> block_type
+  {
+    static_assert(std::is_trivially_copyable_v<value_type>);
+
+    const auto max_size = detail::buffer_pool::max_class_bytes / sizeof(value_type);
+    if (block.data() && block.size() <= max_size && size <= max_size &&
+        detail::buffer_pool::size_class(block.size() * sizeof(value_type)) ==
+          detail::buffer_pool::size_class(size * sizeof(value_type)))
+      return {block.data(), size, block.alignment()};
+
+    const auto result = allocate(size);
+    if (block.data())
+      std::memcpy(result.data(), block.data(),
+                  std::min(block.size(), size) * sizeof(value_type));
+    deallocate(block);
+    return result;
+  }
+};
+
+// Statistics of the calling thread's buffer cache.
+inline auto pool_stats() noexcept -> pool_statistics
+{
+  auto* pool = detail::buffer_pool::local();
+  return pool ? pool->statistics() : pool_statistics{};
+}
+
+// Releases cached buffers of the calling thread until at most `bytes` bytes remain.
+inline auto pool_trim(std::size_t bytes = 0u) noexcept -> void
+{
+  if (auto* pool = detail::buffer_pool::local())
+    pool->trim(bytes);
+}
+
+// Upper bound on the bytes cached by the calling thread.
+inline auto pool_limit() noexcept -> std::size_t
+{
+  auto* pool = detail::buffer_pool::local();
+  return pool ? pool->limit() : 0u;
+}
+
+inline auto set_pool_limit(std::size_t bytes) noexcept -> void
+{
+  if (auto* pool = detail::buffer_pool::local())
+    pool->set_limit(bytes);
+}
+
+} // namespace vlite
+
+#ifdef DOCTEST_LIBRARY_INCLUDED
+
+#include <vlite/vector.hpp>
+
+TEST_CASE("[pool] Recycling vector buffers")
+{
+  using namespace vlite;
+  using pooled_vector = vector<float, pool_allocator<float>>;
+
+  pool_trim();
+  const auto initial = pool_stats();
+
+  const auto a = vector<float>(1.0f, 1000u);
+  for (auto i = 0; i < 10; ++i)
+  {
+    const auto b = pooled_vector(a * 2.0f);
+    const auto c = pooled_vector(b + a);
+    const auto small = pooled_vector(0.0f, 3u);
+    CHECK(all(c == 3.0f));
+  }
+
+  const auto stats = pool_stats();
+  CHECK(stats.misses - initial.misses == 3u);
+  CHECK(stats.hits - initial.hits == 27u);
+  CHECK(stats.cached_blocks == 3u);
+  CHECK(stats.cached_bytes == 2u * 4096u + 64u);
+
+  set_pool_limit(1024u);
+  CHECK(pool_stats().cached_bytes == 64u);
+
+  pool_trim();
+  CHECK(pool_stats().cached_blocks == 0u);
+  set_pool_limit(detail::buffer_pool::default_limit);
+}
+
+#endif // DOCTEST_LIBRARY_INCLUDED
+
+#endif // VLITE_POOL_HPP_INCLUDED
@@ -2,6 +2,8 @@
 #define VLITE_REF_VECTOR_HPP_INCLUDED
 
 #include <vlite/common_vector_base.hpp>
+#include <vlite/functional.hpp>
+#include <vlite/evaluation.hpp>
 #include <vlite/memory_block.hpp>
 #include <vlite/slice.hpp>
 #include <vlite/strided_ref_vector.hpp>
@@ -12,6 +14,12 @@
 namespace vlite
 {
 
+template <typename> class parallel_source;
+
+template <typename, typename> class masked_ref_vector;
+
+template <typename, typename> class indirect_ref_vector;
+
 template <typename T> class ref_vector : public common_vector_base<ref_vector<T>>
 {
   template <typename> friend class ref_vector;
@@ -43,7 +51,20 @@ public:
     if (source.size() != block_.size())
       throw std::runtime_error{"sizes mismatch"};
 
-    std::copy(source.begin(), source.end(), begin());
+    detail::assign(source, block_);
+    return *this;
+  }
+
+  template <typename Vector>
+  auto operator=(const parallel_source<Vector>& source) -> ref_vector&
+  {
+    static_assert(std::is_assignable_v<value_type&, const typename Vector::value_type&>,
+                  "incompatible assignment");
+
+    if (source.size() != block_.size())
+      throw std::runtime_error{"sizes mismatch"};
+
+    source.evaluate(data(), block_.alignment());
     return *this;
   }
 
@@ -64,7 +85,58 @@ public:
     return *this;
   }
 
-  operator ref_vector<const value_type>() const { return {{data(), size()}}; }
+  template <typename Vector>
+  auto operator+=(const common_vector_base<Vector>& source) -> ref_vector&
+  {
+    return compound_assign(source, std::plus<>{});
+  }
+
+  template <typename U, typename = meta::fallback<CommonVector<U>>>
+  auto operator+=(const U& source) -> ref_vector&
+  {
+    return compound_assign(source, std::plus<>{});
+  }
+
+  template <typename Vector>
+  auto operator-=(const common_vector_base<Vector>& source) -> ref_vector&
+  {
+    return compound_assign(source, std::minus<>{});
+  }
+
+  template <typename U, typename = meta::fallback<CommonVector<U>>>
+  auto operator-=(const U& source) -> ref_vector&
+  {
+    return compound_assign(source, std::minus<>{});
+  }
+
+  template <typename Vector>
+  auto operator*=(const common_vector_base<Vector>& source) -> ref_vector&
+  {
+    return compound_assign(source, std::multiplies<>{});
+  }
+
+  template <typename U, typename = meta::fallback<CommonVector<U>>>
+  auto operator*=(const U& source) -> ref_vector&
+  {
+    return compound_assign(source, std::multiplies<>{});
+  }
+
+  template <typename Vector>
+  auto operator/=(const common_vector_base<Vector>& source) -> ref_vector&
+  {
+    return compound_assign(source, std::divides<>{});
+  }
+
+  template <typename U, typename = meta::fallback<CommonVector<U>>>
+  auto operator/=(const U& source) -> ref_vector&
+  {
+    return compound_assign(source, std::divides<>{});
+  }
+
+  operator ref_vector<const value_type>() const
+  {
+    return {{data(), size(), block_.alignment()}};
+  }
 
   operator strided_ref_vector<value_type>() { return {data(), size(), 1u}; }
 
@@ -82,6 +154,44 @@ public:
     return data()[i];
   }
 
+  template <typename Mask, typename = meta::requires<
+                             std::is_same<typename Mask::value_type, bool>>>
+  auto operator[](const common_vector_base<Mask>& mask)
+    -> masked_ref_vector<value_type, decltype(detail::make_operand(mask))>
+  {
+    if (mask.size() != size())
+      throw std::runtime_error{"sizes mismatch"};
+    return {block_, detail::make_operand(mask)};
+  }
+
+  template <typename Mask, typename = meta::requires<
+                             std::is_same<typename Mask::value_type, bool>>>
+  auto operator[](const common_vector_base<Mask>& mask) const
+    -> masked_ref_vector<const value_type, decltype(detail::make_operand(mask))>
+  {
+    if (mask.size() != size())
+      throw std::runtime_error{"sizes mismatch"};
+    return {{data(), size(), block_.alignment()}, detail::make_operand(mask)};
+  }
+
+  template <typename Indices, typename I = typename Indices::value_type,
+            typename = meta::requires<std::is_integral<I>,
+                                      std::negation<std::is_same<I, bool>>>>
+  auto operator[](const common_vector_base<Indices>& indices)
+    -> indirect_ref_vector<value_type, decltype(detail::make_operand(indices))>
+  {
+    return {data(), size(), detail::make_operand(indices), indices.size()};
+  }
+
+  template <typename Indices, typename I = typename Indices::value_type,
+            typename = meta::requires<std::is_integral<I>,
+                                      std::negation<std::is_same<I, bool>>>>
+  auto operator[](const common_vector_base<Indices>& indices) const
+    -> indirect_ref_vector<const value_type, decltype(detail::make_operand(indices))>
+  {
+    return {data(), size(), detail::make_operand(indices), indices.size()};
+  }
+
   auto operator[](every_index) -> ref_vector<value_type> { return *this; }
 
   auto operator[](every_index) const -> ref_vector<const value_type> { return *this; }
@@ -130,9 +240,7 @@ public:
   {
     assert(s.start < size());
 
-    auto maximum_size = size() - s.start;
-    maximum_size += maximum_size % s.stride == 0u ? 0u : 1u;
-    maximum_size /= s.stride;
+    const auto maximum_size = (size() - s.start + s.stride - 1u) / s.stride;
 
     return {data() + s.start, s.size(maximum_size), s.stride};
   }
@@ -141,9 +249,7 @@ public:
   {
     assert(s.start < size());
 
-    auto maximum_size = size() - s.start;
-    maximum_size += maximum_size % s.stride == 0u ? 0u : 1u;
-    maximum_size /= s.stride;
+    const auto maximum_size = (size() - s.start + s.stride - 1u) / s.stride;
 
     return {data() + s.start, s.size(maximum_size), s.stride};
   }
@@ -160,6 +266,33 @@ public:
   auto size() const noexcept { return block_.size(); }
 
 protected:
+  // Updates every element in place in a single pass: the source is fused with the current
+  // values and evaluated by the same kernels as an assignment, so no storage is allocated.
+  template <typename Vector, typename Op>
+  auto compound_assign(const common_vector_base<Vector>& source, Op op) -> ref_vector&
+  {
+    using result = decltype(op(std::declval<value_type&>(), *source.begin()));
+    static_assert(std::is_assignable_v<value_type&, result>, "incompatible assignment");
+
+    if (source.size() != block_.size())
+      throw std::runtime_error{"sizes mismatch"};
+
+    detail::evaluate(apply(*this, source, op), block_);
+    return *this;
+  }
+
+  template <typename U, typename Op>
+  auto compound_assign(const U& source, Op op) -> ref_vector&
+  {
+    using result = decltype(op(std::declval<value_type&>(), source));
+    static_assert(std::is_assignable_v<value_type&, result>, "incompatible assignment");
+
+    const auto expr = binary_expr_vector(detail::make_operand(*this),
+                                         detail::broadcast<U>{source}, op, size());
+    detail::evaluate(expr, block_);
+    return *this;
+  }
+
   auto data() -> value_type* { return block_.data(); }
 
   auto data() const -> const value_type* { return block_.data(); }
@@ -0,0 +1,273 @@
+#ifndef VLITE_SCAN_HPP_INCLUDED
+#define VLITE_SCAN_HPP_INCLUDED
+
+#include <vlite/builder.hpp>
+#include <vlite/common_vector_base.hpp>
+#include <vlite/evaluation.hpp>
+#include <vlite/iterator_traits.hpp>
+#include <vlite/numeric.hpp>
+#include <vlite/parallel.hpp>
+#include <vlite/vector.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace vlite
+{
+
+namespace detail
+{
+
+// Number of elements scanned together in registers by the floating-point kernel.
+constexpr std::size_t scan_group_size = 8u;
+
+// Log-step (Hillis-Steele) scan of a group held in registers: after the step of `Shift`,
+// `x[j]` is the fold of the `2 * Shift` elements ending at `j`.  The steps are unrolled
+// at compile time so that each one becomes a few shuffles and a single vector `op`.
+template <std::size_t Shift, typename R, typename Op, std::size_t... J>
+auto scan_group(R (&x)[scan_group_size], Op op, std::index_sequence<J...> indices) -> void
+{
+  if constexpr (Shift < scan_group_size)
+  {
+    const R y[scan_group_size] = {(J >= Shift ? op(x[J - Shift], x[J]) : x[J])...};
+    ((x[J] = y[J]), ...);
+    scan_group<2u * Shift>(x, op, indices);
+  }
+}
+
+// Inclusive scan of `size` elements starting at `first` into `out`, folded into `carry`
+// when it is set.  Floating-point scans are latency bound, so groups of elements are
+// scanned in registers and only the carry between groups is sequential.
+template <typename R, typename It, typename OutIt, typename Op, std::size_t... J>
+auto scan_n(It first, std::size_t size, OutIt out, Op op, std::optional<R> carry,
+            std::index_sequence<J...> indices) -> void
+{
+  if (size == 0u)
+    return;
+
+  if (!carry)
+  {
+    carry = static_cast<R>(*first);
+    *out = *carry;
+    ++first;
+    ++out;
+    --size;
+  }
+
+  auto value = *std::move(carry);
+  auto i = std::size_t{};
+
+  if constexpr (std::is_floating_point_v<R> && std::is_pointer_v<OutIt> &&
+                is_random_access_iterator<It>::value)
+  {
+    for (; i + scan_group_size <= size; i += scan_group_size)
+    {
+      const auto group = first + static_cast<std::ptrdiff_t>(i);
+      R x[scan_group_size] = {static_cast<R>(group[J])...};
+      scan_group<1u>(x, op, indices);
+      ((out[i + J] = op(value, x[J])), ...);
+      value = out[i + scan_group_size - 1u];
+    }
+    std::advance(first, static_cast<std::ptrdiff_t>(i));
+    out += i;
+  }
+
+  for (; i < size; ++i, ++first, ++out)
+  {
+    value = op(value, static_cast<R>(*first));
+    *out = value;
+  }
+}
+
+template <typename R, typename It, typename OutIt, typename Op>
+auto scan_n(It first, std::size_t size, OutIt out, Op op, std::optional<R> carry) -> void
+{
+  const auto indices = std::make_index_sequence<scan_group_size>{};
+  scan_n(first, size, out, op, std::move(carry), indices);
+}
+
+// Large scans run in two passes over chunks of the default thread pool: every chunk is
+// first scanned on its own, and then folded with the total of the chunks before it, which
+// is the scan of the chunk totals.
+template <typename R, typename It, typename Op>
+auto parallel_scan_n(It first, std::size_t size, R* out, Op op, std::optional<R> carry)
+  -> void
+{
+  auto& pool = default_thread_pool();
+
+  if (size < parallel_threshold || pool.concurrency() == 1u ||
+      !is_random_access_iterator<It>::value)
+  {
+    scan_n(first, size, out, op, std::move(carry));
+    return;
+  }
+
+  constexpr auto chunk = parallel_chunk_size<R>;
+  const auto tasks = (size + chunk - 1u) / chunk;
+
+  pool.run(tasks, [&](std::size_t i) {
+    const auto offset = i * chunk;
+    scan_n(first + static_cast<std::ptrdiff_t>(offset), std::min(chunk, size - offset),
+           out + offset, op, i == 0u ? carry : std::nullopt);
+  });
+
+  auto totals = std::vector<R>();
+  totals.reserve(tasks);
+  totals.push_back(out[chunk - 1u]);
+  for (std::size_t i = 1u; i + 1u < tasks; ++i)
+    totals.push_back(op(totals.back(), out[(i + 1u) * chunk - 1u]));
+
+  pool.run(tasks - 1u, [&](std::size_t i) {
+    const auto offset = (i + 1u) * chunk;
+    const auto total = totals[i];
+    auto* const last = out + std::min(offset + chunk, size);
+    for (auto* it = out + offset; it != last; ++it)
+      *it = op(total, *it);
+  });
+}
+
+// Scan of `size` elements into a new vector, exclusive when `init` is set.
+template <typename R, typename It, typename Op>
+auto scan(It first, std::size_t size, Op op, std::optional<R> init) -> vector<R>
+{
+  auto b = builder<R>(size);
+  if (size == 0u)
+    return vector<R>(std::move(b));
+
+  const auto n = init ? size - 1u : size;
+
+  if constexpr (std::is_trivially_copyable_v<R> &&
+                std::is_trivially_default_constructible_v<R>)
+  {
+    auto* out = b.uninitialized().data();
+    if (init)
+      *out++ = *init;
+    parallel_scan_n(first, n, out, op, std::move(init));
+    b.commit(b.remaining());
+  }
+  else
+  {
+    if (init)
+      b.push_back(*init);
+    scan_n(first, n, std::back_inserter(b), op, std::move(init));
+  }
+
+  return vector<R>(std::move(b));
+}
+
+template <typename Vector, typename Op>
+using scan_result_t =
+  std::decay_t<std::invoke_result_t<Op, const typename Vector::value_type&,
+                                    const typename Vector::value_type&>>;
+
+} // namespace detail
+
+// Running fold of `source` with `op`, which must be associative: element `i` of the result
+// is `op(...op(source[0], source[1])..., source[i])`.  The grouping of the operations is
+// unspecified, so floating-point results may round differently than a sequential loop.
+template <typename Vector, typename Op = std::plus<>>
+auto inclusive_scan(const common_vector_base<Vector>& source, Op op = {})
+{
+  using R = detail::scan_result_t<Vector, Op>;
+  return detail::scan<R>(source.begin(), source.size(), op, std::nullopt);
+}
+
+// Like `inclusive_scan`, shifted by one element: element `i` of the result is the fold
+// of `init` with the elements before `i`.
+template <typename Vector, typename T, typename Op = std::plus<>>
+auto exclusive_scan(const common_vector_base<Vector>& source, const T& init, Op op = {})
+{
+  using value_type = typename Vector::value_type;
+  using R = std::decay_t<std::invoke_result_t<Op, const T&, const value_type&>>;
+  return detail::scan<R>(source.begin(), source.size(), op, std::optional<R>{init});
+}
+
+// Cumulative sum.  Small integer types are promoted as by the built-in `+`.
+template <typename Vector> auto cumsum(const common_vector_base<Vector>& source)
+{
+  return inclusive_scan(source, std::plus<>{});
+}
+
+template <typename Vector> auto cumprod(const common_vector_base<Vector>& source)
+{
+  return inclusive_scan(source, std::multiplies<>{});
+}
+
+// Running minimum.
+template <typename Vector> auto cummin(const common_vector_base<Vector>& source)
+{
+  return inclusive_scan(source, detail::minimum{});
+}
+
+// Running maximum.
+template <typename Vector> auto cummax(const common_vector_base<Vector>& source)
+{
+  return inclusive_scan(source, detail::maximum{});
+}
+
+} // namespace vlite
+
+#ifdef DOCTEST_LIBRARY_INCLUDED
+
+#include <numeric>
+#include <string>
+
+TEST_CASE_TEMPLATE("[scan] Prefix sums", T, doctest::Types<int, long, float, double>)
+{
+  using namespace vlite;
+
+  const auto large = 3u * static_cast<unsigned>(parallel_threshold) + 5u;
+  for (const auto n : {0u, 1u, 7u, 100u, large})
+  {
+    auto a = vector<T>(uninitialized, n);
+    for (auto i = std::size_t{}; i < n; ++i)
+      a[i] = static_cast<T>(i % 7u) - T{3};
+
+    auto expected = std::vector<T>(n);
+    std::partial_sum(a.begin(), a.end(), expected.begin());
+
+    const auto sums = cumsum(a);
+    CHECK(sums.size() == n);
+    CHECK(std::equal(sums.begin(), sums.end(), expected.begin()));
+
+    const auto shifted = exclusive_scan(a * T{2}, T{1});
+    CHECK(shifted.size() == n);
+    for (auto i = std::size_t{}; i < n; i += 997u)
+      CHECK(shifted[i] == T{1} + T{2} * (i == 0u ? T{} : expected[i - 1u]));
+
+    const auto highs = cummax(a);
+    CHECK(highs.size() == n);
+    CHECK(std::is_sorted(highs.begin(), highs.end()));
+    if (n > 4u)
+      CHECK(highs[n - 1u] == T{3});
+  }
+}
+
+TEST_CASE("[scan] Scan operators")
+{
+  using namespace vlite;
+
+  const auto v = vector{3, -1, 4, -1, 5};
+  CHECK(all(cumsum(v) == vector{3, 2, 6, 5, 10}));
+  CHECK(all(cumprod(v) == vector{3, -3, -12, 12, 60}));
+  CHECK(all(cummin(v) == vector{3, -1, -1, -1, -1}));
+  CHECK(all(cummax(v[slice(1u, 4u)]) == vector{-1, 4, 4, 5}));
+  CHECK(all(exclusive_scan(v, 10) == vector{10, 13, 12, 16, 15}));
+
+  const auto c = vector<char>{100, 100, 100};
+  CHECK(all(cumsum(c) == vector{100, 200, 300}));
+
+  const auto words = vector<std::string>{"a", "b", "c"};
+  const auto joined = inclusive_scan(words);
+  CHECK(joined[2] == "abc");
+  CHECK(exclusive_scan(words, std::string{">"})[2] == ">ab");
+}
+
+#endif // DOCTEST_LIBRARY_INCLUDED
+
+#endif // VLITE_SCAN_HPP_INCLUDED
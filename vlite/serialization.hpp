@@ -0,0 +1,506 @@
+#ifndef VLITE_SERIALIZATION_HPP_INCLUDED
+#define VLITE_SERIALIZATION_HPP_INCLUDED
+
+#include <vlite/allocator.hpp>
+#include <vlite/builder.hpp>
+#include <vlite/common_vector_base.hpp>
+#include <vlite/evaluation.hpp>
+#include <vlite/ref_vector.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <complex>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+namespace vlite
+{
+
+// Files hold a sequence of records, each one a header followed by the raw bytes of the
+// elements.  Headers and element data start at multiples of `record_alignment`, so a
+// record can also be read in place with `mapped_vector` at offset `header_offset + 64`.
+//
+//   offset  size  field
+//        0     4  magic "VLTE"
+//        4     2  format version, little endian
+//        6     1  byte order of the elements: 0 little endian, 1 big endian
+//        7     1  element type code (0 for types without a code)
+//        8     4  element size in bytes, little endian
+//       12     4  alignment of the element data and of the next record, little endian
+//       16     8  number of elements, little endian
+//       24    40  zero
+constexpr std::size_t record_alignment = 64u;
+
+constexpr std::uint16_t serialization_version = 1u;
+
+// Default size of the buffers used by the readers and writers.
+constexpr std::size_t io_buffer_size = std::size_t{1u} << 20;
+
+enum class type_code : std::uint8_t
+{
+  unknown = 0u,
+  int8,
+  uint8,
+  int16,
+  uint16,
+  int32,
+  uint32,
+  int64,
+  uint64,
+  float32,
+  float64,
+  complex64,
+  complex128,
+  boolean,
+  character
+};
+
+struct record_header
+{
+  std::uint16_t version;
+  bool big_endian;
+  type_code type;
+  std::size_t element_size;
+  std::size_t size;
+};
+
+namespace detail
+{
+
+template <typename T> constexpr auto type_code_of() noexcept -> type_code
+{
+  if constexpr (std::is_same_v<T, bool>)
+    return type_code::boolean;
+  else if constexpr (std::is_same_v<T, char>)
+    return type_code::character;
+  else if constexpr (std::is_integral_v<T>)
+  {
+    constexpr auto s = std::is_signed_v<T>;
+    switch (sizeof(T))
+    {
+    case 1u:
+      return s ? type_code::int8 : type_code::uint8;
+    case 2u:
+      return s ? type_code::int16 : type_code::uint16;
+    case 4u:
+      return s ? type_code::int32 : type_code::uint32;
+    case 8u:
+      return s ? type_code::int64 : type_code::uint64;
+    default:
+      return type_code::unknown;
+    }
+  }
+  else if constexpr (std::is_same_v<T, float>)
+    return type_code::float32;
+  else if constexpr (std::is_same_v<T, double>)
+    return type_code::float64;
+  else if constexpr (std::is_same_v<T, std::complex<float>>)
+    return type_code::complex64;
+  else if constexpr (std::is_same_v<T, std::complex<double>>)
+    return type_code::complex128;
+  else
+    return type_code::unknown;
+}
+
+// Size of the scalars that make up `T`, which are byte swapped independently when the
+// file and the machine disagree on endianness, or zero if `T` cannot be swapped.
+template <typename T> struct scalar_size : std::integral_constant<std::size_t, 0u>
+{
+};
+
+template <typename T>
+struct scalar_size<std::complex<T>> : std::integral_constant<std::size_t, sizeof(T)>
+{
+};
+
+template <typename T> constexpr auto scalar_size_v()
+{
+  return std::is_arithmetic_v<T> ? sizeof(T) : scalar_size<T>::value;
+}
+
+constexpr auto is_big_endian() noexcept
+{
+#if defined(__BYTE_ORDER__)
+  return __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__;
+#else
+  return false;
+#endif
+}
+
+inline auto swap_bytes(void* data, std::size_t bytes, std::size_t unit) noexcept -> void
+{
+  auto* first = static_cast<unsigned char*>(data);
+  for (auto i = std::size_t{}; i + unit <= bytes; i += unit)
+    std::reverse(first + i, first + i + unit);
+}
+
+inline auto store_le(unsigned char* out, std::uint64_t value, std::size_t bytes) noexcept
+{
+  for (auto i = std::size_t{}; i < bytes; ++i)
+    out[i] = static_cast<unsigned char>(value >> (8u * i));
+}
+
+inline auto load_le(const unsigned char* in, std::size_t bytes) noexcept
+{
+  auto value = std::uint64_t{};
+  for (auto i = std::size_t{}; i < bytes; ++i)
+    value |= std::uint64_t{in[i]} << (8u * i);
+  return value;
+}
+
+constexpr unsigned char record_magic[4] = {'V', 'L', 'T', 'E'};
+
+inline auto padding(std::size_t bytes) noexcept
+{
+  return (record_alignment - bytes % record_alignment) % record_alignment;
+}
+
+// Owns a `std::FILE` with a large stdio buffer and an aligned staging buffer.
+class binary_file
+{
+public:
+  binary_file(const std::string& path, const char* mode, std::size_t buffer_size)
+    : file_{std::fopen(path.c_str(), mode)}
+  {
+    if (!file_)
+      throw std::system_error{errno, std::generic_category(), "fopen " + path};
+
+    try
+    {
+      const auto size = std::max(buffer_size, record_alignment);
+      buffer_ = allocator<unsigned char>{}.allocate(size);
+    }
+    catch (...)
+    {
+      std::fclose(file_);
+      throw;
+    }
+
+    std::setvbuf(file_, nullptr, _IOFBF, buffer_.size());
+  }
+
+  ~binary_file()
+  {
+    if (file_)
+      std::fclose(file_);
+    allocator<unsigned char>{}.deallocate(buffer_);
+  }
+
+  binary_file(const binary_file&) = delete;
+  auto operator=(const binary_file&) -> binary_file& = delete;
+
+  auto close() -> void
+  {
+    if (file_ && std::fclose(std::exchange(file_, nullptr)) != 0)
+      throw std::system_error{errno, std::generic_category(), "fclose"};
+  }
+
+  auto write(const void* data, std::size_t bytes) -> void
+  {
+    if (std::fwrite(data, 1u, bytes, file_) != bytes)
+      throw std::system_error{errno, std::generic_category(), "fwrite"};
+  }
+
+  auto read(void* data, std::size_t bytes) -> void
+  {
+    if (std::fread(data, 1u, bytes, file_) != bytes)
+      throw std::runtime_error{std::feof(file_) ? "unexpected end of file"
+                                                : "fread failed"};
+  }
+
+  // Seeks forward in steps that fit in a `long`, which is 32 bits wide on some platforms.
+  auto skip(std::size_t bytes) -> void
+  {
+    constexpr auto max_step = static_cast<std::size_t>(std::numeric_limits<long>::max());
+
+    while (bytes > 0u)
+    {
+      const auto step = std::min(bytes, max_step);
+      if (std::fseek(file_, static_cast<long>(step), SEEK_CUR) != 0)
+        throw std::system_error{errno, std::generic_category(), "fseek"};
+      bytes -= step;
+    }
+  }
+
+  auto at_end() -> bool
+  {
+    const auto c = std::fgetc(file_);
+    if (c == EOF)
+      return true;
+    std::ungetc(c, file_);
+    return false;
+  }
+
+  auto buffer() const noexcept { return buffer_; }
+
+private:
+  std::FILE* file_;
+  memory_block<unsigned char> buffer_;
+};
+
+} // namespace detail
+
+// Appends records to a file.  Sources are evaluated in chunks that fit the staging
+// buffer, so lazy expressions are written without being materialized.
+class binary_writer
+{
+public:
+  explicit binary_writer(const std::string& path,
+                         std::size_t buffer_size = io_buffer_size)
+    : file_{path, "wb", buffer_size}
+  {
+  }
+
+  template <typename Vector> auto write(const common_vector_base<Vector>& source) -> void
+  {
+    using T = std::decay_t<typename Vector::value_type>;
+    static_assert(std::is_trivially_copyable_v<T>, "elements must be trivially copyable");
+
+    write_header<T>(source.size());
+
+    const auto bytes = source.size() * sizeof(T);
+    const auto first = source.begin();
+
+    if constexpr (std::is_same_v<detail::const_iterator_t<Vector>, const T*>)
+    {
+      file_.write(first, bytes);
+    }
+    else
+    {
+      const auto buffer = file_.buffer();
+      const auto chunk = std::max<std::size_t>(buffer.size() / sizeof(T), 1u);
+      auto* out = reinterpret_cast<T*>(buffer.data());
+
+      for (auto i = std::size_t{}; i < source.size(); i += chunk)
+      {
+        const auto n = std::min(chunk, source.size() - i);
+        detail::evaluate_n(first + static_cast<std::ptrdiff_t>(i), n, out,
+                           buffer.alignment());
+        file_.write(out, n * sizeof(T));
+      }
+    }
+
+    static constexpr unsigned char zeros[record_alignment] = {};
+    file_.write(zeros, detail::padding(bytes));
+  }
+
+  // Flushes the file and reports errors that the destructor would have to swallow.
+  auto close() -> void { file_.close(); }
+
+private:
+  template <typename T> auto write_header(std::size_t size) -> void
+  {
+    unsigned char header[record_alignment] = {};
+    std::memcpy(header, detail::record_magic, sizeof(detail::record_magic));
+    detail::store_le(header + 4u, serialization_version, 2u);
+    header[6] = detail::is_big_endian() ? 1u : 0u;
+    header[7] = static_cast<unsigned char>(detail::type_code_of<T>());
+    detail::store_le(header + 8u, sizeof(T), 4u);
+    detail::store_le(header + 12u, record_alignment, 4u);
+    detail::store_le(header + 16u, size, 8u);
+    file_.write(header, sizeof(header));
+  }
+
+  detail::binary_file file_;
+};
+
+// Reads the records written by `binary_writer`, in order.  Elements are read straight
+// into the destination; files of the other byte order are swapped after reading.
+class binary_reader
+{
+public:
+  explicit binary_reader(const std::string& path,
+                         std::size_t buffer_size = io_buffer_size)
+    : file_{path, "rb", buffer_size}
+  {
+  }
+
+  // Whether all the records have been read.
+  auto at_end() -> bool { return !has_header_ && file_.at_end(); }
+
+  // Header of the next record.
+  auto header() -> const record_header&
+  {
+    if (!has_header_)
+      read_header();
+    return header_;
+  }
+
+  // Reads the next record into `target`, which must have its size.
+  template <typename T> auto read(ref_vector<T>& target) -> void
+  {
+    check<std::remove_const_t<T>>(header());
+    if (header_.size != target.size())
+      throw std::runtime_error{"sizes mismatch"};
+
+    read_elements(target.begin(), target.size());
+    finish();
+  }
+
+  template <typename T> auto read(ref_vector<T>&& target) -> void { read(target); }
+
+  // Appends the elements of the next record to `target`, which must have room for them.
+  template <typename T, typename Allocator>
+  auto read(builder<T, Allocator>& target) -> void
+  {
+    check<T>(header());
+    if (header_.size > target.remaining())
+      throw std::runtime_error{"builder is too small"};
+
+    read_elements(target.uninitialized().data(), header_.size);
+    target.commit(header_.size);
+    finish();
+  }
+
+  // Skips the next record.
+  auto skip() -> void
+  {
+    const auto bytes = header().size * header_.element_size;
+    file_.skip(bytes + detail::padding(bytes));
+    has_header_ = false;
+  }
+
+private:
+  auto read_header() -> void
+  {
+    unsigned char header[record_alignment];
+    file_.read(header, sizeof(header));
+
+    if (std::memcmp(header, detail::record_magic, sizeof(detail::record_magic)) != 0)
+      throw std::runtime_error{"not a vlite record"};
+
+    header_.version = static_cast<std::uint16_t>(detail::load_le(header + 4u, 2u));
+    if (header_.version > serialization_version)
+      throw std::runtime_error{"unsupported format version"};
+
+    header_.big_endian = header[6] != 0u;
+    header_.type = static_cast<type_code>(header[7]);
+    header_.element_size = detail::load_le(header + 8u, 4u);
+    if (detail::load_le(header + 12u, 4u) != record_alignment)
+      throw std::runtime_error{"unsupported record alignment"};
+    const auto size = detail::load_le(header + 16u, 8u);
+    constexpr auto max_bytes = std::numeric_limits<std::size_t>::max() - record_alignment;
+    if (size > max_bytes || (header_.element_size != 0u &&
+                             size > max_bytes / header_.element_size))
+      throw std::runtime_error{"record is too large"};
+    header_.size = static_cast<std::size_t>(size);
+
+    has_header_ = true;
+  }
+
+  template <typename T> static auto check(const record_header& header) -> void
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "elements must be trivially copyable");
+
+    if (header.element_size != sizeof(T) || header.type != detail::type_code_of<T>())
+      throw std::runtime_error{"element type mismatch"};
+    if (header.big_endian != detail::is_big_endian() &&
+        detail::scalar_size_v<T>() == 0u)
+      throw std::runtime_error{"cannot convert the byte order of the elements"};
+  }
+
+  template <typename T> auto read_elements(T* out, std::size_t size) -> void
+  {
+    file_.read(out, size * sizeof(T));
+    if (header_.big_endian != detail::is_big_endian())
+      detail::swap_bytes(out, size * sizeof(T), detail::scalar_size_v<T>());
+  }
+
+  auto finish() -> void
+  {
+    file_.skip(detail::padding(header_.size * header_.element_size));
+    has_header_ = false;
+  }
+
+  detail::binary_file file_;
+  record_header header_ = {};
+  bool has_header_ = false;
+};
+
+} // namespace vlite
+
+#ifdef DOCTEST_LIBRARY_INCLUDED
+
+#include <vlite/vector.hpp>
+
+#include <array>
+#include <filesystem>
+#include <random>
+
+TEST_CASE("[serialization] Writing and reading records")
+{
+  using namespace vlite;
+
+  const auto suffix = std::to_string(std::random_device{}());
+  const auto name = "vlite_serialization_" + suffix + ".bin";
+  const auto path = (std::filesystem::temp_directory_path() / name).string();
+  const auto a = vector{1.0, 2.0, 3.0};
+  const auto b = vector<float>(1.0f, 1000u);
+
+  {
+    auto writer = binary_writer{path, 256u};
+    writer.write(a);
+    writer.write(b * 2.0f + 1.0f);
+    writer.write(vector{1, 2, 3, 4, 5});
+    writer.write(a);
+    writer.close();
+  }
+
+  auto reader = binary_reader{path};
+  CHECK(reader.header().type == type_code::float64);
+  CHECK(reader.header().size == 3u);
+
+  auto c = vector<double>(3u);
+  reader.read(c);
+  CHECK(all(c == a));
+
+  CHECK(reader.header().element_size == sizeof(float));
+  auto d = vector<float>(1000u);
+  CHECK_THROWS(reader.read(d[{0, 10}]));
+  reader.read(d[every]);
+  CHECK(all(d == 3.0f));
+
+  auto e = builder<int>(6u);
+  e.push_back(0);
+  reader.read(e);
+  CHECK(all(vector(std::move(e)) == vector{0, 1, 2, 3, 4, 5}));
+
+  CHECK_FALSE(reader.at_end());
+  reader.skip();
+  CHECK(reader.at_end());
+
+  // A header whose data would not fit in memory is rejected before anything is skipped.
+  {
+    auto header = std::array<unsigned char, record_alignment>{};
+    std::memcpy(header.data(), detail::record_magic, sizeof(detail::record_magic));
+    header[4] = 1u;
+    header[8] = 8u;
+    header[12] = static_cast<unsigned char>(record_alignment);
+    std::fill_n(header.begin() + 16, 8, 0xffu);
+
+    auto file = std::fopen(path.c_str(), "wb");
+    REQUIRE(file);
+    std::fwrite(header.data(), 1u, header.size(), file);
+    std::fclose(file);
+  }
+
+  auto corrupt = binary_reader{path};
+  CHECK_THROWS(corrupt.skip());
+
+  auto swapped = vector<std::uint32_t>{0x01020304u};
+  detail::swap_bytes(swapped.data(), sizeof(std::uint32_t), sizeof(std::uint32_t));
+  CHECK(swapped[0] == 0x04030201u);
+
+  std::remove(path.c_str());
+}
+
+#endif // DOCTEST_LIBRARY_INCLUDED
+
+#endif // VLITE_SERIALIZATION_HPP_INCLUDED
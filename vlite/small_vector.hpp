@@ -0,0 +1,292 @@
+#ifndef VLITE_SMALL_VECTOR_HPP_INCLUDED
+#define VLITE_SMALL_VECTOR_HPP_INCLUDED
+
+#include <vlite/allocator.hpp>
+#include <vlite/evaluation.hpp>
+#include <vlite/ref_vector.hpp>
+
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+namespace vlite
+{
+
+// Vector that keeps up to `N` elements inside the object and only reaches the allocator
+// for larger sizes, for workloads made of many tiny vectors (coordinates, per-class
+// scores).  Like `vector`, it is a `ref_vector`, so it can be sliced and used in
+// expressions.
+template <typename T, std::size_t N, typename Allocator = allocator<T>>
+class small_vector : private Allocator, public ref_vector<T>
+{
+  static_assert(N > 0u, "inline capacity must not be empty");
+
+public:
+  using value_type = T;
+
+  using allocator_type = Allocator;
+
+  using iterator = value_type*;
+
+  using const_iterator = const value_type*;
+
+  using size_type = std::size_t;
+
+  using difference_type = std::ptrdiff_t;
+
+  static constexpr std::size_t inline_capacity = N;
+
+  explicit small_vector(std::size_t size = 0u, const Allocator& alloc = Allocator{})
+    : Allocator{alloc}
+  {
+    acquire(size);
+    initialize([&](auto block) { this->construct(block); });
+  }
+
+  small_vector(const value_type& value, std::size_t size,
+               const Allocator& alloc = Allocator{})
+    : Allocator{alloc}
+  {
+    acquire(size);
+    initialize([&](auto block) { this->construct(block, value); });
+  }
+
+  small_vector(std::initializer_list<value_type> values,
+               const Allocator& alloc = Allocator{})
+    : Allocator{alloc}
+  {
+    acquire(values.size());
+    initialize([&](auto block) { this->construct(block, values.begin()); });
+  }
+
+  template <typename Vector>
+  small_vector(const common_vector_base<Vector>& other,
+               const Allocator& alloc = Allocator{})
+    : Allocator{alloc}
+  {
+    static_assert(std::is_constructible_v<T, const typename Vector::value_type&>);
+
+    acquire(other.size());
+    if constexpr (detail::is_vectorizable_v<value_type, Vector>)
+      initialize([&](auto block) { detail::evaluate(other, block); });
+    else
+      initialize([&](auto block) { this->construct(block, other.begin()); });
+  }
+
+  template <typename It, typename R = typename std::iterator_traits<It>::reference>
+  small_vector(It begin, It end, const Allocator& alloc = Allocator{})
+    : Allocator{alloc}
+  {
+    static_assert(std::is_constructible<value_type, R>());
+
+    acquire(std::distance(begin, end));
+    initialize([&](auto block) { this->construct(block, begin, end); });
+  }
+
+  ~small_vector() noexcept { reset(); }
+
+  small_vector(const small_vector& source)
+    : Allocator{source.get_allocator()}
+    , ref_vector<value_type>{}
+  {
+    acquire(source.size());
+    initialize([&](auto block) { this->construct(block, source.data()); });
+  }
+
+  small_vector(small_vector&& source) noexcept(std::is_nothrow_move_constructible_v<T>)
+    : Allocator{source.get_allocator()}
+  {
+    take(source);
+  }
+
+  auto operator=(const small_vector& source) -> small_vector&
+  {
+    if (this != &source)
+    {
+      auto copy = source;
+      *this = std::move(copy);
+    }
+    return *this;
+  }
+
+  auto operator=(small_vector&& source) noexcept(std::is_nothrow_move_constructible_v<T>)
+    -> small_vector&
+  {
+    if (this != &source)
+    {
+      reset();
+      static_cast<Allocator&>(*this) = source.get_allocator();
+      take(source);
+    }
+    return *this;
+  }
+
+  // Whether the elements live inside the object.
+  auto is_inline() const noexcept { return data() == inline_data(); }
+
+  auto get_allocator() const noexcept -> Allocator { return *this; }
+
+  template <typename U> auto operator+=(const U& source) -> small_vector&
+  {
+    ref_vector<T>::operator+=(source);
+    return *this;
+  }
+
+  template <typename U> auto operator-=(const U& source) -> small_vector&
+  {
+    ref_vector<T>::operator-=(source);
+    return *this;
+  }
+
+  template <typename U> auto operator*=(const U& source) -> small_vector&
+  {
+    ref_vector<T>::operator*=(source);
+    return *this;
+  }
+
+  template <typename U> auto operator/=(const U& source) -> small_vector&
+  {
+    ref_vector<T>::operator/=(source);
+    return *this;
+  }
+
+  auto data() noexcept -> value_type* { return this->block_.data(); }
+
+  auto data() const noexcept -> const value_type* { return this->block_.data(); }
+
+  using ref_vector<T>::size;
+  using ref_vector<T>::begin;
+  using ref_vector<T>::end;
+  using ref_vector<T>::cbegin;
+  using ref_vector<T>::cend;
+
+private:
+  auto inline_data() noexcept { return reinterpret_cast<value_type*>(storage_); }
+
+  auto inline_data() const noexcept
+  {
+    return reinterpret_cast<const value_type*>(storage_);
+  }
+
+  // Points the block at the inline storage or at a new allocation, without constructing.
+  auto acquire(std::size_t size) -> void
+  {
+    if (size <= N)
+      this->block_ = {inline_data(), size, alignof(value_type)};
+    else
+      this->block_ = this->allocate(size);
+  }
+
+  auto release() noexcept -> void
+  {
+    if (!is_inline())
+      this->deallocate(this->block_);
+    this->block_ = {inline_data(), 0u, alignof(value_type)};
+  }
+
+  auto reset() noexcept -> void
+  {
+    this->destroy(this->block_);
+    release();
+  }
+
+  template <typename F> auto initialize(F construct) -> void
+  {
+    try
+    {
+      construct(this->block_);
+    }
+    catch (...)
+    {
+      release();
+      throw;
+    }
+  }
+
+  // Takes the elements of `source`, which must not own any, and leaves it empty.
+  auto take(small_vector& source) noexcept(std::is_nothrow_move_constructible_v<T>)
+    -> void
+  {
+    if (source.is_inline())
+    {
+      acquire(source.size());
+      initialize([&](auto block) {
+        std::uninitialized_move_n(source.data(), block.size(), block.data());
+      });
+      source.reset();
+    }
+    else
+    {
+      this->block_ = source.block_;
+      source.block_ = {source.inline_data(), 0u, alignof(value_type)};
+    }
+  }
+
+  alignas(value_type) unsigned char storage_[N * sizeof(value_type)];
+};
+
+} // namespace vlite
+
+#ifdef DOCTEST_LIBRARY_INCLUDED
+
+#include <vlite/vector.hpp>
+
+#include <stdexcept>
+#include <string>
+
+TEST_CASE("[small_vector] Inline and heap storage")
+{
+  using namespace vlite;
+
+  auto a = small_vector<float, 4u>{1.0f, 2.0f, 3.0f};
+  CHECK(a.is_inline());
+  CHECK(a.size() == 3u);
+  CHECK(a[2] == 3.0f);
+
+  const auto b = small_vector<float, 4u>(a * 2.0f + 1.0f);
+  CHECK(b.is_inline());
+  CHECK(all(b == vector{3.0f, 5.0f, 7.0f}));
+  CHECK(all(b[{1, 2}] == vector{5.0f, 7.0f}));
+
+  a += b;
+  CHECK(a[0] == 4.0f);
+
+  const auto c = small_vector<float, 4u>(1.0f, 10u);
+  CHECK_FALSE(c.is_inline());
+  CHECK(sum(c) == 10.0f);
+
+  auto d = c;
+  CHECK_FALSE(d.is_inline());
+  CHECK(d.data() != c.data());
+
+  const auto* data = d.data();
+  const auto e = std::move(d);
+  CHECK(e.data() == data);
+  CHECK(d.size() == 0u);
+
+  d = a;
+  CHECK(d.is_inline());
+  CHECK(all(d == a));
+
+  auto strings = small_vector<std::string, 2u>{"a", "b"};
+  auto moved = std::move(strings);
+  CHECK(moved.is_inline());
+  CHECK(moved[1] == "b");
+
+  moved = small_vector<std::string, 2u>{"c", "d", "e"};
+  CHECK_FALSE(moved.is_inline());
+  CHECK(moved[2] == "e");
+
+  // The heap block is released when the evaluation throws.
+  const auto failing = [](float x) -> float {
+    if (x > 5.0f)
+      throw std::runtime_error{"evaluation failed"};
+    return x;
+  };
+  CHECK_THROWS((small_vector<float, 4u>(vlite::apply(c * 10.0f, failing))));
+}
+
+#endif // DOCTEST_LIBRARY_INCLUDED
+
+#endif // VLITE_SMALL_VECTOR_HPP_INCLUDED
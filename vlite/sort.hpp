@@ -0,0 +1,518 @@
+#ifndef VLITE_SORT_HPP_INCLUDED
+#define VLITE_SORT_HPP_INCLUDED
+
+#include <vlite/builder.hpp>
+#include <vlite/common_vector_base.hpp>
+#include <vlite/evaluation.hpp>
+#include <vlite/parallel.hpp>
+#include <vlite/ref_vector.hpp>
+#include <vlite/strided_ref_vector.hpp>
+#include <vlite/vector.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace vlite
+{
+
+namespace detail
+{
+
+// Below this size, comparison sorting beats the fixed cost of the radix histograms.
+constexpr std::size_t radix_sort_min_size = 256u;
+
+// Number of bits sorted by each pass of the radix sort.
+constexpr std::size_t radix_bits = 8u;
+
+constexpr std::size_t radix_buckets = std::size_t{1u} << radix_bits;
+
+template <std::size_t Size> struct radix_key_of;
+
+template <> struct radix_key_of<1u>
+{
+  using type = std::uint8_t;
+};
+
+template <> struct radix_key_of<2u>
+{
+  using type = std::uint16_t;
+};
+
+template <> struct radix_key_of<4u>
+{
+  using type = std::uint32_t;
+};
+
+template <> struct radix_key_of<8u>
+{
+  using type = std::uint64_t;
+};
+
+template <typename T> using radix_key_t = typename radix_key_of<sizeof(T)>::type;
+
+template <typename T, bool IsRadix> struct sort_key
+{
+  using type = T;
+};
+
+template <typename T> struct sort_key<T, true>
+{
+  using type = radix_key_t<T>;
+};
+
+// Integer and floating-point elements ordered by `std::less` are radix sorted.
+template <typename T, typename Compare>
+constexpr bool is_radix_sortable_v =
+  std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, long double> &&
+  (std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<T>>);
+
+// Unsigned integer whose order is the order of `value`: the sign bit of signed integers
+// is flipped, and so are all the bits of negative floating-point values.  Both zeros get
+// the key of +0.0, as they are equivalent for `std::less`.  NaNs are sorted after positive
+// infinity, or before negative infinity when their sign bit is set.
+template <typename T> auto radix_key(T value) noexcept -> radix_key_t<T>
+{
+  using key_type = radix_key_t<T>;
+  constexpr auto sign = static_cast<key_type>(key_type{1u} << (8u * sizeof(T) - 1u));
+
+  if constexpr (std::is_floating_point_v<T>)
+    value = value == T{} ? T{} : value;
+
+  auto key = key_type{};
+  std::memcpy(&key, &value, sizeof(T));
+
+  if constexpr (std::is_floating_point_v<T>)
+    return static_cast<key_type>((key & sign) ? ~key : key | sign);
+  else if constexpr (std::is_signed_v<T>)
+    return static_cast<key_type>(key ^ sign);
+  else
+    return key;
+}
+
+// Stable LSD radix sort of `data` by `key(element)`, an unsigned integer, using `buffer`
+// of the same size as scratch.  The histograms of every digit are computed in a single
+// pass, and digits that are the same for all the elements are skipped.
+template <typename R, typename Key>
+auto radix_sort_n(R* data, R* buffer, std::size_t size, Key key) -> void
+{
+  using key_type = std::decay_t<decltype(key(*data))>;
+  constexpr auto digits = sizeof(key_type) * 8u / radix_bits;
+
+  if (size < 2u)
+    return;
+
+  std::size_t counts[digits][radix_buckets] = {};
+  for (auto i = std::size_t{}; i < size; ++i)
+  {
+    const auto k = key(data[i]);
+    for (auto d = std::size_t{}; d < digits; ++d)
+      ++counts[d][(k >> (d * radix_bits)) & (radix_buckets - 1u)];
+  }
+
+  auto* from = data;
+  auto* to = buffer;
+
+  for (auto d = std::size_t{}; d < digits; ++d)
+  {
+    const auto shift = d * radix_bits;
+    const auto first = (key(from[0]) >> shift) & (radix_buckets - 1u);
+    if (counts[d][first] == size)
+      continue;
+
+    std::size_t offsets[radix_buckets];
+    auto offset = std::size_t{};
+    for (auto b = std::size_t{}; b < radix_buckets; ++b)
+    {
+      offsets[b] = offset;
+      offset += counts[d][b];
+    }
+
+    for (auto i = std::size_t{}; i < size; ++i)
+      to[offsets[(key(from[i]) >> shift) & (radix_buckets - 1u)]++] = from[i];
+
+    std::swap(from, to);
+  }
+
+  if (from != data)
+    std::copy_n(from, size, data);
+}
+
+// Number of elements of `a`, among the first `diagonal` elements of the stable merge of
+// `a` and `b`.  This is the merge path split point: merges of consecutive diagonals are
+// independent of each other.
+template <typename T, typename Compare>
+auto merge_path(const T* a, std::size_t a_size, const T* b, std::size_t b_size,
+                std::size_t diagonal, Compare comp) -> std::size_t
+{
+  auto low = diagonal > b_size ? diagonal - b_size : 0u;
+  auto high = std::min(diagonal, a_size);
+
+  while (low < high)
+  {
+    const auto i = low + (high - low) / 2u;
+    if (!comp(b[diagonal - i - 1u], a[i]))
+      low = i + 1u;
+    else
+      high = i;
+  }
+  return low;
+}
+
+// Stable merge of the sorted ranges `a` and `b` into `out`, split along the merge path
+// into independent pieces, one per task of `pool`.
+template <typename T, typename Compare>
+auto parallel_merge(const T* a, std::size_t a_size, const T* b, std::size_t b_size, T* out,
+                    Compare comp, thread_pool& pool) -> void
+{
+  const auto size = a_size + b_size;
+  const auto tasks =
+    std::max<std::size_t>(std::min(pool.concurrency(), size / parallel_chunk_size<T>), 1u);
+
+  pool.run(tasks, [&](std::size_t k) {
+    const auto first = size * k / tasks;
+    const auto last = size * (k + 1u) / tasks;
+    const auto i = merge_path(a, a_size, b, b_size, first, comp);
+    const auto j = merge_path(a, a_size, b, b_size, last, comp);
+    std::merge(a + i, a + j, b + (first - i), b + (last - j), out + first, comp);
+  });
+}
+
+// Sorts `data` by calling `sort_chunk(first, size, buffer)` on chunks of at least
+// `parallel_threshold` elements in parallel, and then merging the sorted chunks pairwise
+// along the merge path.  The result is stable when `sort_chunk` is.  `buffer` is scratch
+// space of the size of the chunk, only allocated when `UsesBuffer` or for the merges.
+template <bool UsesBuffer, typename T, typename Compare, typename SortChunk>
+auto chunked_sort_n(T* data, std::size_t size, Compare comp, SortChunk sort_chunk)
+  -> void
+{
+  auto& pool = default_thread_pool();
+  const auto chunks =
+    std::min(pool.concurrency(), std::max<std::size_t>(size / parallel_threshold, 1u));
+
+  if (chunks == 1u || !std::is_trivially_copyable_v<T>)
+  {
+    if constexpr (UsesBuffer)
+      sort_chunk(data, size, std::unique_ptr<T[]>{new T[size]}.get());
+    else
+      sort_chunk(data, size, static_cast<T*>(nullptr));
+    return;
+  }
+
+  const auto buffer = std::unique_ptr<T[]>{new T[size]};
+
+  auto bounds = std::vector<std::size_t>(chunks + 1u);
+  for (auto k = std::size_t{}; k <= chunks; ++k)
+    bounds[k] = size * k / chunks;
+
+  pool.run(chunks, [&](std::size_t k) {
+    const auto first = bounds[k];
+    sort_chunk(data + first, bounds[k + 1u] - first, buffer.get() + first);
+  });
+
+  auto* from = data;
+  auto* to = buffer.get();
+
+  while (bounds.size() > 2u)
+  {
+    auto merged = std::vector<std::size_t>{0u};
+    for (auto k = std::size_t{}; k + 1u < bounds.size(); k += 2u)
+    {
+      const auto first = bounds[k];
+      const auto middle = bounds[k + 1u];
+      const auto last = k + 2u < bounds.size() ? bounds[k + 2u] : middle;
+
+      parallel_merge(from + first, middle - first, from + middle, last - middle,
+                     to + first, comp, pool);
+      merged.push_back(last);
+    }
+    bounds = std::move(merged);
+    std::swap(from, to);
+  }
+
+  if (from != data)
+    std::copy_n(from, size, data);
+}
+
+template <typename T, typename Compare>
+auto sort_n(T* data, std::size_t size, Compare comp, bool stable) -> void
+{
+  if constexpr (is_radix_sortable_v<T, Compare>)
+  {
+    if (size >= radix_sort_min_size)
+    {
+      const auto sort_chunk = [](T* first, std::size_t n, T* buffer) {
+        radix_sort_n(first, buffer, n, [](T value) { return radix_key(value); });
+      };
+      chunked_sort_n<true>(data, size, comp, sort_chunk);
+      return;
+    }
+  }
+
+  if (stable)
+    chunked_sort_n<false>(data, size, comp, [comp](T* first, std::size_t n, T*) {
+      std::stable_sort(first, first + n, comp);
+    });
+  else
+    chunked_sort_n<false>(data, size, comp, [comp](T* first, std::size_t n, T*) {
+      std::sort(first, first + n, comp);
+    });
+}
+
+// Sorts the elements of a strided view in a contiguous copy.
+template <typename T, typename Compare>
+auto sort_strided(strided_ref_vector<T>& vec, Compare comp, bool stable) -> void
+{
+  const auto size = vec.size();
+  const auto values = std::unique_ptr<T[]>{new T[size]};
+  const auto first = vec.begin();
+
+  if constexpr (std::is_arithmetic_v<T>)
+    strided_gather(first.base(), first.stride(), size, values.get());
+  else
+    std::move(first, vec.end(), values.get());
+
+  sort_n(values.get(), size, comp, stable);
+
+  if constexpr (std::is_arithmetic_v<T>)
+    strided_scatter(values.get(), size, first.base(), first.stride());
+  else
+    std::move(values.get(), values.get() + size, first);
+}
+
+template <typename K> struct keyed_index
+{
+  K key;
+  std::size_t index;
+};
+
+} // namespace detail
+
+// Sorts the elements in place.  Integer and floating-point elements ordered by `std::less`
+// are radix sorted; large inputs are sorted in chunks by multiple threads and then merged.
+template <typename T, typename Compare = std::less<>>
+auto sort(ref_vector<T>& vec, Compare comp = {}) -> void
+{
+  detail::sort_n(vec.begin(), vec.size(), comp, false);
+}
+
+template <typename T, typename Compare = std::less<>>
+auto sort(ref_vector<T>&& vec, Compare comp = {}) -> void
+{
+  sort(vec, comp);
+}
+
+template <typename T, typename Compare = std::less<>>
+auto sort(strided_ref_vector<T>& vec, Compare comp = {}) -> void
+{
+  detail::sort_strided(vec, comp, false);
+}
+
+template <typename T, typename Compare = std::less<>>
+auto sort(strided_ref_vector<T>&& vec, Compare comp = {}) -> void
+{
+  sort(vec, comp);
+}
+
+// Like `sort`, keeping the order of equivalent elements.
+template <typename T, typename Compare = std::less<>>
+auto stable_sort(ref_vector<T>& vec, Compare comp = {}) -> void
+{
+  detail::sort_n(vec.begin(), vec.size(), comp, true);
+}
+
+template <typename T, typename Compare = std::less<>>
+auto stable_sort(ref_vector<T>&& vec, Compare comp = {}) -> void
+{
+  stable_sort(vec, comp);
+}
+
+template <typename T, typename Compare = std::less<>>
+auto stable_sort(strided_ref_vector<T>& vec, Compare comp = {}) -> void
+{
+  detail::sort_strided(vec, comp, true);
+}
+
+template <typename T, typename Compare = std::less<>>
+auto stable_sort(strided_ref_vector<T>&& vec, Compare comp = {}) -> void
+{
+  stable_sort(vec, comp);
+}
+
+// Indices that stably sort `source`: `source[result[0]]` is its smallest element.  Keys
+// are evaluated once and sorted together with their indices.
+template <typename Vector, typename Compare = std::less<>>
+auto argsort(const common_vector_base<Vector>& source, Compare comp = {})
+  -> vector<std::size_t>
+{
+  using value_type = std::decay_t<typename Vector::value_type>;
+  constexpr auto is_radix = detail::is_radix_sortable_v<value_type, Compare>;
+  using key_type = typename detail::sort_key<value_type, is_radix>::type;
+  using record = detail::keyed_index<key_type>;
+
+  const auto size = source.size();
+  auto records = std::vector<record>();
+  records.reserve(size);
+
+  auto index = std::size_t{};
+  for (auto it = source.begin(); index < size; ++it, ++index)
+  {
+    if constexpr (is_radix)
+      records.push_back({detail::radix_key(static_cast<value_type>(*it)), index});
+    else
+      records.push_back({*it, index});
+  }
+
+  auto* data = records.data();
+  if constexpr (is_radix)
+  {
+    const auto by_key = [](const record& a, const record& b) { return a.key < b.key; };
+    if (size >= detail::radix_sort_min_size)
+    {
+      const auto sort_chunk = [](record* first, std::size_t n, record* buffer) {
+        detail::radix_sort_n(first, buffer, n, [](const record& r) { return r.key; });
+      };
+      detail::chunked_sort_n<true>(data, size, by_key, sort_chunk);
+    }
+    else
+      std::stable_sort(data, data + size, by_key);
+  }
+  else
+  {
+    const auto by_key = [comp](const record& a, const record& b) {
+      return comp(a.key, b.key);
+    };
+    const auto sort_chunk = [by_key](record* first, std::size_t n, record*) {
+      std::stable_sort(first, first + n, by_key);
+    };
+    detail::chunked_sort_n<false>(data, size, by_key, sort_chunk);
+  }
+
+  auto result = builder<std::size_t>(size);
+  for (const auto& r : records)
+    result.unchecked_push_back(r.index);
+  return vector<std::size_t>(std::move(result));
+}
+
+// Reorders the elements so that those satisfying `pred` come first, and returns how many
+// they are.
+template <typename T, typename Predicate>
+auto partition(ref_vector<T>& vec, Predicate pred) -> std::size_t
+{
+  return static_cast<std::size_t>(std::partition(vec.begin(), vec.end(), pred) -
+                                  vec.begin());
+}
+
+template <typename T, typename Predicate>
+auto partition(ref_vector<T>&& vec, Predicate pred) -> std::size_t
+{
+  return partition(vec, pred);
+}
+
+template <typename T, typename Predicate>
+auto partition(strided_ref_vector<T>& vec, Predicate pred) -> std::size_t
+{
+  return static_cast<std::size_t>(std::partition(vec.begin(), vec.end(), pred) -
+                                  vec.begin());
+}
+
+template <typename T, typename Predicate>
+auto partition(strided_ref_vector<T>&& vec, Predicate pred) -> std::size_t
+{
+  return partition(vec, pred);
+}
+
+} // namespace vlite
+
+#ifdef DOCTEST_LIBRARY_INCLUDED
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+
+TEST_CASE_TEMPLATE("[sort] Sorting numbers", T,
+                   doctest::Types<char, unsigned short, int, long, float, double>)
+{
+  using namespace vlite;
+
+  auto engine = std::mt19937_64{42u};
+  auto next = [&] {
+    if constexpr (std::is_floating_point_v<T>)
+      return static_cast<T>(std::uniform_real_distribution<double>{-1e3, 1e3}(engine));
+    else
+      return static_cast<T>(engine());
+  };
+
+  const auto large = 4u * static_cast<unsigned>(parallel_threshold);
+  for (const auto n : {0u, 1u, 100u, 5000u, large})
+  {
+    auto a = vector<T>(uninitialized, n);
+    for (auto i = std::size_t{}; i < n; ++i)
+      a[i] = next();
+
+    auto expected = std::vector<T>(a.begin(), a.end());
+    std::sort(expected.begin(), expected.end());
+
+    const auto order = argsort(a);
+    CHECK(order.size() == n);
+
+    auto b = vector<T>(a);
+    sort(b);
+    CHECK(std::equal(b.begin(), b.end(), expected.begin()));
+    CHECK(std::is_sorted(order.begin(), order.end(), [&](auto i, auto j) {
+      return a[i] < a[j] || (!(a[j] < a[i]) && i < j);
+    }));
+
+    stable_sort(a, std::greater<>{});
+    CHECK(std::equal(a.begin(), a.end(), expected.rbegin()));
+  }
+}
+
+TEST_CASE("[sort] Sorting views and records")
+{
+  using namespace vlite;
+
+  const auto inf = std::numeric_limits<double>::infinity();
+
+  auto a = vector{-0.5, 3.0, -inf, 2.0, 1.0, -4.0};
+  sort(a[slice(1u, 4u)]);
+  CHECK(all(a == vector{-0.5, -inf, 1.0, 2.0, 3.0, -4.0}));
+
+  sort(a[strided_slice(1u, 2u, 2u)], std::greater<>{});
+  CHECK(all(a == vector{-0.5, 2.0, 1.0, -inf, 3.0, -4.0}));
+
+  const auto positive = partition(a, [](double x) { return x > 0.0; });
+  CHECK(positive == 3u);
+  CHECK(all(a[slice(0u, 3u)] > 0.0));
+
+  // Signed zeros are equivalent, so the stable algorithms keep them in place.
+  auto zeros = vector<double>(0.0, 1000u);
+  zeros[1] = -0.0;
+  const auto zero_order = argsort(zeros);
+  CHECK(zero_order[0] == 0u);
+  CHECK(zero_order[1] == 1u);
+  stable_sort(zeros);
+  CHECK(!std::signbit(zeros[0]));
+  CHECK(std::signbit(zeros[1]));
+
+  auto words = vector<std::string>{"pear", "fig", "apple", "kiwi"};
+  const auto by_size = [](const std::string& x, const std::string& y) {
+    return x.size() < y.size();
+  };
+  CHECK(all(argsort(words, by_size) == vector<std::size_t>{1u, 0u, 3u, 2u}));
+  stable_sort(words, by_size);
+  CHECK(words[1] == "pear");
+  CHECK(words[2] == "kiwi");
+  sort(words);
+  CHECK(words[0] == "apple");
+}
+
+#endif // DOCTEST_LIBRARY_INCLUDED
+
+#endif // VLITE_SORT_HPP_INCLUDED
@@ -1,7 +1,9 @@
 #ifndef VLITE_STRIDED_ITERATOR_HPP_INCLUDED
 #define VLITE_STRIDED_ITERATOR_HPP_INCLUDED
 
+#include <cstddef>
 #include <iterator>
+#include <type_traits>
 
 namespace vlite
 {
@@ -9,7 +11,7 @@ template <typename T> class strided_iterator
 {
 public:
   using iterator_category = std::random_access_iterator_tag;
-  using value_type = T;
+  using value_type = std::remove_cv_t<T>;
   using difference_type = std::ptrdiff_t;
   using pointer = T*;
   using reference = T&;
@@ -44,6 +46,26 @@ public:
     return !(*this == other);
   }
 
+  constexpr auto operator<(const strided_iterator& other) const noexcept -> bool
+  {
+    return data_ + current_ < other.data_ + other.current_;
+  }
+
+  constexpr auto operator>(const strided_iterator& other) const noexcept -> bool
+  {
+    return other < *this;
+  }
+
+  constexpr auto operator<=(const strided_iterator& other) const noexcept -> bool
+  {
+    return !(other < *this);
+  }
+
+  constexpr auto operator>=(const strided_iterator& other) const noexcept -> bool
+  {
+    return !(*this < other);
+  }
+
   constexpr auto operator++() noexcept -> strided_iterator&
   {
     current_ += stride_;
@@ -70,6 +92,18 @@ public:
     return copy;
   }
 
+  constexpr auto operator+=(difference_type n) noexcept -> strided_iterator&
+  {
+    current_ += n * stride_;
+    return *this;
+  }
+
+  constexpr auto operator-=(difference_type n) noexcept -> strided_iterator&
+  {
+    current_ -= n * stride_;
+    return *this;
+  }
+
   constexpr auto operator+(difference_type n) const noexcept -> strided_iterator
   {
     auto copy = *this;
@@ -84,11 +118,23 @@ public:
     return copy;
   }
 
-  constexpr auto operator[](difference_type n) const noexcept -> value_type&
+  constexpr auto operator-(const strided_iterator& other) const noexcept -> difference_type
+  {
+    return ((data_ + current_) - (other.data_ + other.current_)) /
+           static_cast<difference_type>(stride_);
+  }
+
+  constexpr auto operator[](difference_type n) const noexcept -> reference
   {
     return *(*this + n);
   }
 
+  // Address of the current element.
+  constexpr auto base() const noexcept -> pointer { return data_ + current_; }
+
+  // Distance, in elements of the underlying array, between consecutive positions.
+  constexpr auto stride() const noexcept { return stride_; }
+
 private:
   T* data_ = nullptr;
   std::size_t stride_ = 0u;
@@ -103,13 +149,18 @@ constexpr auto operator+(typename strided_iterator<T>::difference_type n,
   return iterator + n;
 }
 
-template <typename T>
-constexpr auto operator-(typename strided_iterator<T>::difference_type n,
-                         const strided_iterator<T>& iterator) noexcept
-  -> strided_iterator<T>
+namespace detail
 {
-  return iterator - n;
-}
+
+template <typename T> struct is_strided_iterator : std::false_type
+{
+};
+
+template <typename T> struct is_strided_iterator<strided_iterator<T>> : std::true_type
+{
+};
+
+} // namespace detail
 
 } // namespace vlite
 
@@ -2,12 +2,16 @@
 #define VLITE_STRIDED_REF_VECTOR_HPP_INCLUDED
 
 #include <vlite/common_vector_base.hpp>
+#include <vlite/evaluation.hpp>
+#include <vlite/functional.hpp>
 #include <vlite/slice.hpp>
 #include <vlite/strided_iterator.hpp>
 
 namespace vlite
 {
 
+template <typename> class parallel_source;
+
 template <typename T>
 class strided_ref_vector : public common_vector_base<strided_ref_vector<T>>
 {
@@ -42,8 +46,20 @@ public:
     if (source.size() != this->size())
       throw std::runtime_error{"sizes mismatch"};
 
-    std::copy(source.begin(), source.end(), begin());
+    detail::evaluate_n(source.begin(), size(), begin());
+    return *this;
+  }
+
+  template <typename Vector>
+  auto operator=(const parallel_source<Vector>& source) -> strided_ref_vector&
+  {
+    static_assert(std::is_assignable_v<value_type&, const typename Vector::value_type&>,
+                  "incompatible assignment");
+
+    if (source.size() != this->size())
+      throw std::runtime_error{"sizes mismatch"};
 
+    source.evaluate(begin());
     return *this;
   }
 
@@ -51,9 +67,7 @@ public:
   auto operator=(const U& source) -> strided_ref_vector&
   {
     static_assert(std::is_assignable<value_type&, U>::value, "incompatible assignment");
-    std::fill(begin(), end(), source);
-    for (auto& elem : *this)
-      elem = source;
+    detail::strided_fill(data(), stride(), size(), source);
     return *this;
   }
 
@@ -62,10 +76,58 @@ public:
     if (source.size() != size())
       throw std::runtime_error{"sizes mismatch"};
 
-    std::copy(source.begin(), source.end(), this->begin());
+    detail::evaluate_n(source.begin(), size(), begin());
     return *this;
   }
 
+  template <typename Vector>
+  auto operator+=(const common_vector_base<Vector>& source) -> strided_ref_vector&
+  {
+    return compound_assign(source, std::plus<>{});
+  }
+
+  template <typename U, typename = meta::fallback<CommonVector<U>>>
+  auto operator+=(const U& source) -> strided_ref_vector&
+  {
+    return compound_assign(source, std::plus<>{});
+  }
+
+  template <typename Vector>
+  auto operator-=(const common_vector_base<Vector>& source) -> strided_ref_vector&
+  {
+    return compound_assign(source, std::minus<>{});
+  }
+
+  template <typename U, typename = meta::fallback<CommonVector<U>>>
+  auto operator-=(const U& source) -> strided_ref_vector&
+  {
+    return compound_assign(source, std::minus<>{});
+  }
+
+  template <typename Vector>
+  auto operator*=(const common_vector_base<Vector>& source) -> strided_ref_vector&
+  {
+    return compound_assign(source, std::multiplies<>{});
+  }
+
+  template <typename U, typename = meta::fallback<CommonVector<U>>>
+  auto operator*=(const U& source) -> strided_ref_vector&
+  {
+    return compound_assign(source, std::multiplies<>{});
+  }
+
+  template <typename Vector>
+  auto operator/=(const common_vector_base<Vector>& source) -> strided_ref_vector&
+  {
+    return compound_assign(source, std::divides<>{});
+  }
+
+  template <typename U, typename = meta::fallback<CommonVector<U>>>
+  auto operator/=(const U& source) -> strided_ref_vector&
+  {
+    return compound_assign(source, std::divides<>{});
+  }
+
   operator strided_ref_vector<const value_type>() const
   {
     return {data(), size(), stride()};
@@ -134,9 +196,7 @@ public:
   {
     assert(s.start < size());
 
-    auto maximum_size = size() - s.start;
-    maximum_size += maximum_size % s.stride == 0u ? 0u : 1u;
-    maximum_size /= s.stride;
+    const auto maximum_size = (size() - s.start + s.stride - 1u) / s.stride;
 
     return {data() + s.start * stride_, s.size(maximum_size), s.stride * stride_};
   }
@@ -145,9 +205,7 @@ public:
   {
     assert(s.start < size());
 
-    auto maximum_size = size() - s.start;
-    maximum_size += maximum_size % s.stride == 0u ? 0u : 1u;
-    maximum_size /= s.stride;
+    const auto maximum_size = (size() - s.start + s.stride - 1u) / s.stride;
 
     return {data() + s.start * stride_, s.size(maximum_size), s.stride * stride_};
   }
@@ -167,6 +225,34 @@ public:
   auto size() const noexcept { return size_; }
 
 protected:
+  // Updates every element in place in a single pass: the source is fused with the current
+  // values and evaluated by the same kernels as an assignment, so no storage is allocated.
+  template <typename Vector, typename Op>
+  auto compound_assign(const common_vector_base<Vector>& source, Op op) -> strided_ref_vector&
+  {
+    using result = decltype(op(std::declval<value_type&>(), *source.begin()));
+    static_assert(std::is_assignable_v<value_type&, result>, "incompatible assignment");
+
+    if (source.size() != size())
+      throw std::runtime_error{"sizes mismatch"};
+
+    const auto expr = apply(*this, source, op);
+    detail::evaluate_n(expr.begin(), size(), begin());
+    return *this;
+  }
+
+  template <typename U, typename Op>
+  auto compound_assign(const U& source, Op op) -> strided_ref_vector&
+  {
+    using result = decltype(op(std::declval<value_type&>(), source));
+    static_assert(std::is_assignable_v<value_type&, result>, "incompatible assignment");
+
+    const auto expr = binary_expr_vector(detail::make_operand(*this),
+                                         detail::broadcast<U>{source}, op, size());
+    detail::evaluate_n(expr.begin(), size(), begin());
+    return *this;
+  }
+
   auto data() -> value_type* { return data_; }
 
   auto data() const -> const value_type* { return data_; }
@@ -0,0 +1,83 @@
+#ifndef VLITE_TERNARY_EXPR_VECTOR_HPP_INCLUDED
+#define VLITE_TERNARY_EXPR_VECTOR_HPP_INCLUDED
+
+#include <vlite/common_vector_base.hpp>
+#include <vlite/expr_vector.hpp>
+#include <vlite/iterator_traits.hpp>
+
+#include <cassert>
+#include <type_traits>
+
+namespace vlite
+{
+
+template <typename First, typename Second, typename Third, typename Op>
+class ternary_expr_vector
+  : public expr_vector<Op>,
+    public common_vector_base<ternary_expr_vector<First, Second, Third, Op>>
+{
+  using first_result = detail::operand_result_t<First>;
+  using second_result = detail::operand_result_t<Second>;
+  using third_result = detail::operand_result_t<Third>;
+
+public:
+  using value_type = std::decay_t<
+    std::invoke_result_t<const Op&, first_result, second_result, third_result>>;
+
+  using typename expr_vector<Op>::size_type;
+
+  using typename expr_vector<Op>::difference_type;
+
+  static constexpr bool is_contiguous = detail::is_contiguous_iterator_v<First> &&
+                                        detail::is_contiguous_iterator_v<Second> &&
+                                        detail::is_contiguous_iterator_v<Third>;
+
+  using iterator = expr_iterator<ternary_expr_vector>;
+
+  using const_iterator = iterator;
+
+  ternary_expr_vector(First first, Second second, Third third, Op op, std::size_t size)
+    : expr_vector<Op>(std::move(op), size)
+    , first_{std::move(first)}
+    , second_{std::move(second)}
+    , third_{std::move(third)}
+  {
+  }
+
+  auto begin() const -> const_iterator { return cbegin(); }
+  auto end() const -> const_iterator { return cend(); }
+
+  auto cbegin() const -> const_iterator { return {this, 0}; }
+  auto cend() const -> const_iterator
+  {
+    return {this, static_cast<difference_type>(size())};
+  }
+
+  auto operator[](size_type i) const -> value_type
+  {
+    assert(i < size());
+    return compute(i);
+  }
+
+  // Element at `i`, without bounds checks, for the iterators and the parent nodes.
+  auto compute(size_type i) const -> value_type
+  {
+    return this->operate(detail::operand_at(first_, i), detail::operand_at(second_, i),
+                         detail::operand_at(third_, i));
+  }
+
+  using expr_vector<Op>::size;
+
+private:
+  First first_;
+  Second second_;
+  Third third_;
+};
+
+template <typename First, typename Second, typename Third, typename Op>
+ternary_expr_vector(First, Second, Third, Op, std::size_t)
+  ->ternary_expr_vector<First, Second, Third, Op>;
+
+} // namespace vlite
+
+#endif // VLITE_TERNARY_EXPR_VECTOR_HPP_INCLUDED
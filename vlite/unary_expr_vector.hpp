@@ -3,105 +3,68 @@
 
 #include <vlite/common_vector_base.hpp>
 #include <vlite/expr_vector.hpp>
+#include <vlite/iterator_traits.hpp>
 
-#include <iterator>
+#include <cassert>
+#include <type_traits>
 
 namespace vlite
 {
 
-template <typename It, typename Op>
+template <typename Operand, typename Op>
 class unary_expr_vector : public expr_vector<Op>,
-                          public common_vector_base<unary_expr_vector<It, Op>>
+                          public common_vector_base<unary_expr_vector<Operand, Op>>
 {
-  using iterator_result = decltype(*std::declval<It>());
+  using operand_result = detail::operand_result_t<Operand>;
 
 public:
-  using value_type = std::decay_t<std::result_of_t<Op(iterator_result)>>;
+  using value_type = std::decay_t<std::invoke_result_t<const Op&, operand_result>>;
 
   using typename expr_vector<Op>::size_type;
 
   using typename expr_vector<Op>::difference_type;
 
-  class iterator
-  {
-    friend class unary_expr_vector<It, Op>;
-
-  public:
-    using iterator_category = std::input_iterator_tag;
-    using value_type = std::decay_t<std::result_of_t<Op(iterator_result)>>;
-
-    using difference_type = std::ptrdiff_t;
-    using reference = void;
-    using pointer = void;
-
-    constexpr iterator() = default;
-
-    constexpr iterator(const iterator& source) = default;
-    constexpr iterator(iterator&& source) noexcept = default;
-
-    constexpr iterator& operator=(const iterator& source) = default;
-    constexpr iterator& operator=(iterator&& source) noexcept = default;
-
-    constexpr auto operator++() -> iterator&
-    {
-      ++it_;
-      return *this;
-    }
-
-    constexpr auto operator++(int) -> iterator
-    {
-      auto copy = *this;
-      ++(*this);
-      return copy;
-    }
-
-    constexpr auto operator==(const iterator& other) const { return it_ == other.it_; }
-
-    constexpr auto operator!=(const iterator& other) const { return !(*this == other); }
-
-    constexpr auto operator*() const -> value_type { return source_->operate(*it_); }
-
-  private:
-    constexpr iterator(It it, const unary_expr_vector* source)
-      : it_{it}
-      , source_{source}
-    {
-    }
+  static constexpr bool is_contiguous = detail::is_contiguous_iterator_v<Operand>;
 
-    It it_;
-    const unary_expr_vector* source_;
-  };
+  using iterator = expr_iterator<unary_expr_vector>;
 
   using const_iterator = iterator;
 
-public:
-  unary_expr_vector(It it_first, It it_last, Op op, std::size_t size)
+  unary_expr_vector(Operand operand, Op op, std::size_t size)
     : expr_vector<Op>(std::move(op), size)
-    , it_first_{it_first}
-    , it_last_{it_last}
+    , operand_{std::move(operand)}
   {
   }
 
-  unary_expr_vector(const unary_expr_vector& source) = delete;
-  unary_expr_vector(unary_expr_vector&& source) noexcept = delete;
-
-  auto operator=(const unary_expr_vector& source) -> unary_expr_vector& = delete;
-  auto operator=(unary_expr_vector&& source) noexcept -> unary_expr_vector& = delete;
-
   auto begin() const -> const_iterator { return cbegin(); }
   auto end() const -> const_iterator { return cend(); }
 
-  auto cbegin() const -> iterator { return {it_first_, this}; }
-  auto cend() const -> iterator { return {it_last_, this}; }
+  auto cbegin() const -> const_iterator { return {this, 0}; }
+  auto cend() const -> const_iterator
+  {
+    return {this, static_cast<difference_type>(size())};
+  }
+
+  auto operator[](size_type i) const -> value_type
+  {
+    assert(i < size());
+    return compute(i);
+  }
+
+  // Element at `i`, without bounds checks, for the iterators and the parent nodes.
+  auto compute(size_type i) const -> value_type
+  {
+    return this->operate(detail::operand_at(operand_, i));
+  }
 
   using expr_vector<Op>::size;
 
 private:
-  It it_first_, it_last_;
+  Operand operand_;
 };
 
-template <typename It, typename Op>
-unary_expr_vector(It, It, Op, std::size_t)->unary_expr_vector<It, Op>;
+template <typename Operand, typename Op>
+unary_expr_vector(Operand, Op, std::size_t)->unary_expr_vector<Operand, Op>;
 
 } // namespace vlite
 
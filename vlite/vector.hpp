@@ -3,21 +3,32 @@
 
 #include <vlite/allocator.hpp>
 #include <vlite/builder.hpp>
+#include <vlite/cat_vector.hpp>
 #include <vlite/functional.hpp>
+#include <vlite/indirect_ref_vector.hpp>
+#include <vlite/masked_ref_vector.hpp>
 #include <vlite/numeric.hpp>
+#include <vlite/parallel.hpp>
 #include <vlite/ref_vector.hpp>
 #include <vlite/ref_vector_concept.hpp>
 
 namespace vlite
 {
 
-template <typename T> class vector : public ref_vector<T>, private allocator<T>
+template <typename T, typename Allocator> class growable_vector;
+
+template <typename T, typename Allocator, typename Expr> class owning_expr_vector;
+
+template <typename T, typename Allocator>
+class vector : private Allocator, public ref_vector<T>
 {
-  template <typename> friend class vector;
+  template <typename, typename> friend class vector;
 
 public:
   using value_type = T;
 
+  using allocator_type = Allocator;
+
   using iterator = value_type*;
 
   using const_iterator = const value_type*;
@@ -26,8 +37,9 @@ public:
 
   using difference_type = std::ptrdiff_t;
 
-  explicit vector(std::size_t size)
-    : ref_vector<value_type>{this->allocate(size)}
+  explicit vector(std::size_t size, const Allocator& alloc = Allocator{})
+    : Allocator{alloc}
+    , ref_vector<value_type>{this->allocate(size)}
   {
     try
     {
@@ -40,8 +52,9 @@ public:
     }
   }
 
-  vector(const value_type& value, std::size_t size)
-    : ref_vector<value_type>{this->allocate(size)}
+  vector(const value_type& value, std::size_t size, const Allocator& alloc = Allocator{})
+    : Allocator{alloc}
+    , ref_vector<value_type>{this->allocate(size)}
   {
     try
     {
@@ -54,8 +67,9 @@ public:
     }
   }
 
-  vector(std::initializer_list<value_type> values)
-    : ref_vector<value_type>{this->allocate(values.size())}
+  vector(std::initializer_list<value_type> values, const Allocator& alloc = Allocator{})
+    : Allocator{alloc}
+    , ref_vector<value_type>{this->allocate(values.size())}
   {
     try
     {
@@ -69,13 +83,18 @@ public:
   }
 
   template <typename Vector>
-  vector(const common_vector_base<Vector>& other)
-    : ref_vector<value_type>{this->allocate(other.size())}
+  vector(const common_vector_base<Vector>& other, const Allocator& alloc = Allocator{})
+    : Allocator{alloc}
+    , ref_vector<value_type>{this->allocate(other.size())}
   {
     static_assert(std::is_constructible_v<T, const typename Vector::value_type&>);
+
     try
     {
-      this->construct(this->block_, other.begin());
+      if constexpr (std::is_arithmetic_v<value_type>)
+        detail::evaluate(other, this->block_);
+      else
+        this->construct(this->block_, other.begin());
     }
     catch (...)
     {
@@ -84,9 +103,38 @@ public:
     }
   }
 
+  template <typename Vector>
+  vector(const parallel_source<Vector>& other, const Allocator& alloc = Allocator{})
+    : Allocator{alloc}
+    , ref_vector<value_type>{this->allocate(other.size())}
+  {
+    static_assert(std::is_constructible_v<T, const typename Vector::value_type&>);
+
+    try
+    {
+      if constexpr (std::is_arithmetic_v<value_type>)
+        other.evaluate(this->block_.data(), this->block_.alignment());
+      else
+        this->construct(this->block_, other.begin());
+    }
+    catch (...)
+    {
+      this->deallocate(this->block_);
+      throw;
+    }
+  }
+
+  // Evaluates a chain of operators on an rvalue vector into the buffer of that vector.
+  template <typename Expr>
+  vector(owning_expr_vector<T, Allocator, Expr>&& source)
+    : vector(std::move(source).evaluate())
+  {
+  }
+
   template <typename It, typename R = typename std::iterator_traits<It>::reference>
-  vector(It begin, It end)
-    : ref_vector<value_type>{this->allocate(std::distance(begin, end))}
+  vector(It begin, It end, const Allocator& alloc = Allocator{})
+    : Allocator{alloc}
+    , ref_vector<value_type>{this->allocate(std::distance(begin, end))}
   {
     static_assert(std::is_constructible<value_type, R>());
     try
@@ -100,15 +148,25 @@ public:
     }
   }
 
-  explicit vector(uninitialized_t, std::size_t size = 0u)
-    : ref_vector<value_type>{this->allocate(size)}
+  explicit vector(uninitialized_t, std::size_t size = 0u,
+                  const Allocator& alloc = Allocator{})
+    : Allocator{alloc}
+    , ref_vector<value_type>{this->allocate(size)}
   {
     static_assert(std::is_pod_v<value_type>,
                   "Uninitialized vector is only allowed for POD types");
   }
 
-  explicit vector(builder<value_type> b)
-    : ref_vector<value_type>{b.release()}
+  explicit vector(builder<value_type, Allocator> b)
+    : Allocator{b.get_allocator()}
+    , ref_vector<value_type>{b.release()}
+  {
+  }
+
+  // Takes over the elements of `source`; trivially copyable elements are not copied.
+  explicit vector(growable_vector<value_type, Allocator> source)
+    : Allocator{source.get_allocator()}
+    , ref_vector<value_type>{source.release()}
   {
   }
 
@@ -119,7 +177,8 @@ public:
   }
 
   vector(const vector& source)
-    : ref_vector<value_type>{this->allocate(source.size())}
+    : Allocator{source.get_allocator()}
+    , ref_vector<value_type>{this->allocate(source.size())}
   {
     try
     {
@@ -157,13 +216,54 @@ public:
   }
 
   vector(vector&& source) noexcept
-    : ref_vector<value_type>{std::exchange(source.block_, {})}
+    : Allocator{source.get_allocator()}
+    , ref_vector<value_type>{std::exchange(source.block_, {})}
   {
   }
 
   auto operator=(vector&& source) noexcept -> vector&
   {
     std::swap(this->block_, source.block_);
+    std::swap(static_cast<Allocator&>(*this), static_cast<Allocator&>(source));
+    return *this;
+  }
+
+  // Assigns `source`, reusing the current block when the sizes match instead of
+  // allocating a new one.  Unlike `operator=`, the source may only read each element of
+  // this vector at the position it assigns.
+  template <typename Vector>
+  auto assign(const common_vector_base<Vector>& source) -> vector&
+  {
+    if (source.size() != size())
+      return *this = vector(source, get_allocator());
+
+    ref_vector<T>::operator=(source);
+    return *this;
+  }
+
+  auto get_allocator() const noexcept -> Allocator { return *this; }
+
+  template <typename U> auto operator+=(const U& source) -> vector&
+  {
+    ref_vector<T>::operator+=(source);
+    return *this;
+  }
+
+  template <typename U> auto operator-=(const U& source) -> vector&
+  {
+    ref_vector<T>::operator-=(source);
+    return *this;
+  }
+
+  template <typename U> auto operator*=(const U& source) -> vector&
+  {
+    ref_vector<T>::operator*=(source);
+    return *this;
+  }
+
+  template <typename U> auto operator/=(const U& source) -> vector&
+  {
+    ref_vector<T>::operator/=(source);
     return *this;
   }
 
@@ -182,6 +282,262 @@ template <typename T> vector(const T&, std::size_t)->vector<T>;
 template <typename T> vector(std::initializer_list<T>)->vector<T>;
 template <typename Vector>
 vector(common_vector_base<Vector>)->vector<std::decay_t<typename Vector::value_type>>;
+template <typename Vector>
+vector(parallel_source<Vector>)->vector<std::decay_t<typename Vector::value_type>>;
+template <typename T, typename Allocator>
+vector(growable_vector<T, Allocator>)->vector<T, Allocator>;
+template <typename T, typename Allocator, typename Expr>
+vector(owning_expr_vector<T, Allocator, Expr>)->vector<T, Allocator>;
+
+// Result of operators with an rvalue vector operand: the lazy expression of the whole
+// chain of operators, together with the buffer of that operand.  Operators on an rvalue
+// of it extend the expression, and converting it to a vector evaluates the chain into the
+// buffer in a single pass.  Like other expressions, it references the vectors it reads;
+// as an operand of other expressions, it is referenced too.
+template <typename T, typename Allocator, typename Expr>
+class owning_expr_vector
+  : public common_vector_base<owning_expr_vector<T, Allocator, Expr>>
+{
+public:
+  using value_type = T;
+
+  using size_type = std::size_t;
+
+  using difference_type = std::ptrdiff_t;
+
+  static constexpr bool is_contiguous = detail::is_contiguous_iterator_v<Expr>;
+
+  using iterator = expr_iterator<owning_expr_vector>;
+
+  using const_iterator = iterator;
+
+  owning_expr_vector(vector<T, Allocator> buffer, Expr expression)
+    : buffer_{std::move(buffer)}
+    , expression_{std::move(expression)}
+  {
+  }
+
+  owning_expr_vector(owning_expr_vector&&) = default;
+  owning_expr_vector(const owning_expr_vector&) = delete;
+
+  auto operator=(const owning_expr_vector&) -> owning_expr_vector& = delete;
+
+  auto begin() const -> const_iterator { return cbegin(); }
+  auto end() const -> const_iterator { return cend(); }
+
+  auto cbegin() const -> const_iterator { return {this, 0}; }
+  auto cend() const -> const_iterator
+  {
+    return {this, static_cast<difference_type>(size())};
+  }
+
+  auto operator[](size_type i) const -> value_type
+  {
+    assert(i < size());
+    return compute(i);
+  }
+
+  auto compute(size_type i) const -> value_type
+  {
+    return static_cast<value_type>(detail::operand_at(expression_, i));
+  }
+
+  auto size() const noexcept { return buffer_.size(); }
+
+  auto expression() const noexcept -> const Expr& { return expression_; }
+
+  // The buffer, without evaluating the expression into it.
+  auto buffer() && -> vector<T, Allocator> { return std::move(buffer_); }
+
+  auto evaluate() && -> vector<T, Allocator>
+  {
+    buffer_[every] = expression_;
+    return std::move(buffer_);
+  }
+
+private:
+  vector<T, Allocator> buffer_;
+  Expr expression_;
+};
+
+namespace detail
+{
+
+template <typename R, typename Op, typename... Args>
+using invokes_to =
+  std::is_same<R, std::decay_t<std::invoke_result_t<Op, const Args&...>>>;
+
+template <typename T, typename Allocator, typename Vector>
+auto steal(vector<T, Allocator>&& target, const common_vector_base<Vector>& result)
+  -> vector<T, Allocator>
+{
+  target[every] = result;
+  return std::move(target);
+}
+
+// Rvalue operands whose buffer the operators write their result into.
+template <typename T> struct is_owner : std::false_type
+{
+};
+
+template <typename T, typename Allocator>
+struct is_owner<vector<T, Allocator>> : std::true_type
+{
+};
+
+template <typename T, typename Allocator, typename Expr>
+struct is_owner<owning_expr_vector<T, Allocator, Expr>> : std::true_type
+{
+};
+
+// Operand that reads the value of an owner.
+template <typename T, typename Allocator>
+auto owned_operand(const vector<T, Allocator>& owner)
+{
+  return owner.begin();
+}
+
+template <typename T, typename Allocator, typename Expr>
+auto owned_operand(const owning_expr_vector<T, Allocator, Expr>& owner) -> Expr
+{
+  return owner.expression();
+}
+
+template <typename T, typename Allocator>
+auto release(vector<T, Allocator>&& owner) -> vector<T, Allocator>
+{
+  return std::move(owner);
+}
+
+template <typename T, typename Allocator, typename Expr>
+auto release(owning_expr_vector<T, Allocator, Expr>&& owner) -> vector<T, Allocator>
+{
+  return std::move(owner).buffer();
+}
+
+// Moves the buffer of `owner` into a chain that evaluates `expression` into it.
+template <typename Owner, typename Expr> auto chain(Owner&& owner, Expr expression)
+{
+  auto buffer = release(std::move(owner));
+  using buffer_type = decltype(buffer);
+  return owning_expr_vector<typename buffer_type::value_type,
+                            typename buffer_type::allocator_type, Expr>{
+    std::move(buffer), std::move(expression)};
+}
+
+} // namespace detail
+
+// Operations with an rvalue vector operand whose element type is also the result type
+// write the result into the buffer of that operand instead of allocating one.  They
+// return a lazy `owning_expr_vector`, so that `vector(std::move(a) * 2.0 + b)` is fused
+// into a single multiply-add pass over the buffer of `a`.  When both operands own a
+// buffer, the operation is evaluated right away into the buffer of the left one.
+
+#define RVALUE_OPERATIONS_LIST                                                           \
+  RVALUE_UNARY_OPERATION(-, std::negate<>)                                               \
+  RVALUE_UNARY_OPERATION(!, std::logical_not<>)                                          \
+  RVALUE_BINARY_COMBINATIONS(+, std::plus<>)                                             \
+  RVALUE_BINARY_COMBINATIONS(-, std::minus<>)                                            \
+  RVALUE_BINARY_COMBINATIONS(*, std::multiplies<>)                                       \
+  RVALUE_BINARY_COMBINATIONS(/, std::divides<>)                                          \
+  RVALUE_BINARY_COMBINATIONS(%, std::modulus<>)
+
+#define RVALUE_BINARY_COMBINATIONS(OP__, FUNCTOR__)                                      \
+  RVALUE_LEFT_OPERATION(OP__, FUNCTOR__)                                                 \
+  RVALUE_RIGHT_OPERATION(OP__, FUNCTOR__)                                                \
+  RVALUE_BOTH_OPERATION(OP__, FUNCTOR__)                                                 \
+  RVALUE_RIGHT_TYPE_OPERATION(OP__, FUNCTOR__)                                           \
+  RVALUE_LEFT_TYPE_OPERATION(OP__, FUNCTOR__)
+
+#define RVALUE_LEFT_OPERATION(OP__, FUNCTOR__)                                           \
+  template <typename Owner, typename Vector, typename T = typename Owner::value_type,    \
+            typename U = typename Vector::value_type,                                    \
+            typename = meta::requires<detail::is_owner<Owner>,                           \
+                                      detail::invokes_to<T, FUNCTOR__, T, U>>>           \
+  auto operator OP__(Owner&& lhs, const common_vector_base<Vector>& rhs)                 \
+  {                                                                                      \
+    detail::check_sizes(lhs, rhs);                                                       \
+    return detail::chain(std::move(lhs),                                                 \
+                         detail::make_binary(detail::owned_operand(lhs),                 \
+                                             detail::make_operand(rhs), FUNCTOR__{},     \
+                                             lhs.size()));                               \
+  }
+
+#define RVALUE_RIGHT_OPERATION(OP__, FUNCTOR__)                                          \
+  template <typename Vector, typename Owner, typename T = typename Owner::value_type,    \
+            typename U = typename Vector::value_type,                                    \
+            typename = meta::requires<detail::is_owner<Owner>,                           \
+                                      detail::invokes_to<T, FUNCTOR__, U, T>>>           \
+  auto operator OP__(const common_vector_base<Vector>& lhs, Owner&& rhs)                 \
+  {                                                                                      \
+    detail::check_sizes(lhs, rhs);                                                       \
+    return detail::chain(std::move(rhs),                                                 \
+                         detail::make_binary(detail::make_operand(lhs),                  \
+                                             detail::owned_operand(rhs), FUNCTOR__{},    \
+                                             lhs.size()));                               \
+  }
+
+#define RVALUE_BOTH_OPERATION(OP__, FUNCTOR__)                                           \
+  template <typename OwnerA, typename OwnerB, typename T = typename OwnerA::value_type,   \
+            typename U = typename OwnerB::value_type,                                    \
+            typename = meta::requires<detail::is_owner<OwnerA>, detail::is_owner<OwnerB>, \
+                                      detail::invokes_to<T, FUNCTOR__, T, U>>>           \
+  auto operator OP__(OwnerA&& lhs, OwnerB&& rhs)                                         \
+  {                                                                                      \
+    detail::check_sizes(lhs, rhs);                                                       \
+    const auto result = detail::make_binary(detail::owned_operand(lhs),                  \
+                                            detail::owned_operand(rhs), FUNCTOR__{},     \
+                                            lhs.size());                                 \
+    return detail::steal(detail::release(std::move(lhs)), result);                       \
+  }
+
+#define RVALUE_RIGHT_TYPE_OPERATION(OP__, FUNCTOR__)                                     \
+  template <typename Owner, typename U, typename T = typename Owner::value_type,         \
+            typename = meta::requires<detail::is_owner<Owner>,                           \
+                                      detail::invokes_to<T, FUNCTOR__, T, U>>,           \
+            typename = meta::fallback<CommonVector<U>>>                                  \
+  auto operator OP__(Owner&& lhs, U rhs)                                                 \
+  {                                                                                      \
+    return detail::chain(std::move(lhs),                                                 \
+                         detail::make_binary(detail::owned_operand(lhs),                 \
+                                             detail::broadcast<U>{std::move(rhs)},       \
+                                             FUNCTOR__{}, lhs.size()));                  \
+  }
+
+#define RVALUE_LEFT_TYPE_OPERATION(OP__, FUNCTOR__)                                      \
+  template <typename U, typename Owner, typename T = typename Owner::value_type,         \
+            typename = meta::requires<detail::is_owner<Owner>,                           \
+                                      detail::invokes_to<T, FUNCTOR__, U, T>>,           \
+            typename = meta::fallback<CommonVector<U>>>                                  \
+  auto operator OP__(U lhs, Owner&& rhs)                                                 \
+  {                                                                                      \
+    return detail::chain(std::move(rhs),                                                 \
+                         detail::make_binary(detail::broadcast<U>{std::move(lhs)},       \
+                                             detail::owned_operand(rhs), FUNCTOR__{},    \
+                                             rhs.size()));                               \
+  }
+
+#define RVALUE_UNARY_OPERATION(OP__, FUNCTOR__)                                          \
+  template <typename Owner, typename T = typename Owner::value_type,                     \
+            typename = meta::requires<detail::is_owner<Owner>,                           \
+                                      detail::invokes_to<T, FUNCTOR__, T>>>              \
+  auto operator OP__(Owner&& operand)                                                    \
+  {                                                                                      \
+    return detail::chain(std::move(operand),                                             \
+                         unary_expr_vector(detail::owned_operand(operand), FUNCTOR__{},  \
+                                           operand.size()));                             \
+  }
+
+RVALUE_OPERATIONS_LIST
+
+#undef RVALUE_UNARY_OPERATION
+#undef RVALUE_LEFT_TYPE_OPERATION
+#undef RVALUE_RIGHT_TYPE_OPERATION
+#undef RVALUE_BOTH_OPERATION
+#undef RVALUE_RIGHT_OPERATION
+#undef RVALUE_LEFT_OPERATION
+#undef RVALUE_BINARY_COMBINATIONS
+#undef RVALUE_OPERATIONS_LIST
 
 template <typename Vector, typename = meta::requires<RefVector<Vector>>>
 constexpr auto ref(Vector vec)
@@ -189,9 +545,34 @@ constexpr auto ref(Vector vec)
   return vec;
 }
 
-template <typename T> constexpr auto ref(vector<T>& vec) { return vec[every]; }
+template <typename T, typename Allocator>
+constexpr auto ref(vector<T, Allocator>& vec)
+{
+  return vec[every];
+}
 
-template <typename T> constexpr auto ref(const vector<T>& vec) { return vec[every]; }
+template <typename T, typename Allocator>
+constexpr auto ref(const vector<T, Allocator>& vec)
+{
+  return vec[every];
+}
+
+// Evaluates `source` once into a new vector, so that an expression traversed several times
+// is not recomputed on every traversal.
+template <typename Vector,
+          typename Allocator = allocator<std::decay_t<typename Vector::value_type>>>
+auto eval(const common_vector_base<Vector>& source, const Allocator& alloc = Allocator{})
+{
+  return vector<std::decay_t<typename Vector::value_type>, Allocator>(source, alloc);
+}
+
+// Concatenates vectors and scalars, in order, into a new vector.  Arrays of the element
+// type are copied with memcpy; see `cat_view` for the lazy form.
+template <typename... Args> auto cat(const Args&... args)
+{
+  const auto view = cat_view(args...);
+  return vector<typename decltype(view)::value_type>(view);
+}
 
 } // namespace vlite
 
@@ -199,6 +580,10 @@ template <typename T> constexpr auto ref(const vector<T>& vec) { return vec[ever
 
 #include <algorithm>
 #include <complex>
+#include <list>
+#include <numeric>
+#include <string>
+#include <vector>
 
 using test_types =
   doctest::Types<char, short, int, long, double, float, std::complex<float>>;
@@ -267,6 +652,32 @@ TEST_CASE("[vector] Assignment")
   CHECK(a.size() == 10u);
   CHECK(std::find_if_not(a.begin(), a.end(), [](const auto& x) { return x == 1; }) ==
         a.end());
+
+  // Views of the same vector are copied as by memmove, in both directions.
+  for (const auto n : {20u, 200u})
+  {
+    auto b = vector<double>(uninitialized, n);
+    std::iota(b.begin(), b.end(), 0.0);
+    const auto& cb = b;
+
+    b[{1, every}] = cb[{0, n - 1u}];
+    CHECK(b[0] == 0.0);
+    for (auto i = 1u; i < n; ++i)
+      CHECK(b[i] == i - 1.0);
+
+    b[{0, n - 1u}] = cb[{1, every}];
+    for (auto i = 0u; i + 1u < n; ++i)
+      CHECK(b[i] == i);
+
+    auto c = vector<float>(uninitialized, n);
+    std::iota(c.begin(), c.end(), 0.0f);
+    c[{2, every}] = c[{0, n - 2u}];
+    CHECK(c[n - 1u] == n - 3.0f);
+
+    std::iota(c.begin(), c.end(), 0.0f);
+    c[{n / 2u, every}] = c[{0, every, 2}];
+    CHECK(c[n - 1u] == n - 2.0f);
+  }
 }
 
 template <typename Vector, typename = vlite::meta::requires<vlite::RefVector<Vector>>>
@@ -302,6 +713,555 @@ TEST_CASE("[vector] Operations")
   CHECK(any(a == 1));
 }
 
+TEST_CASE("[vector] Contiguous evaluation")
+{
+  using namespace vlite;
+
+  // Sizes around the block size exercise the peeling, block and tail loops.
+  for (const auto size : {0u, 1u, 63u, 64u, 65u, 1000u})
+  {
+    auto a = vector<float>(2.0f, size);
+    auto b = vector<float>(3.0f, size);
+
+    const auto c = vector<float>(a * b + 1.0f);
+    CHECK(c.size() == size);
+    CHECK(all(c == 7.0f));
+
+    a[every] = a + b;
+    CHECK(all(a == 5.0f));
+
+    const auto d = vector<double>(-b);
+    CHECK(all(d == -3.0));
+  }
+
+  // The block is released when the evaluation throws.
+  const auto failing = [](float x) -> float {
+    if (x > 500.0f)
+      throw std::runtime_error{"evaluation failed"};
+    return x;
+  };
+  auto e = vector<float>(1000u);
+  std::iota(e.begin(), e.end(), 0.0f);
+  CHECK_THROWS(vector<float>(apply(e, failing)));
+  CHECK_THROWS(vector<float>(parallel(apply(e, failing), 0u)));
+}
+
+// User-defined vector whose iterators are only bidirectional.
+class list_vector : public vlite::common_vector_base<list_vector>
+{
+public:
+  using value_type = int;
+
+  list_vector(std::initializer_list<int> values)
+    : values_{values}
+  {
+  }
+
+  auto size() const noexcept { return values_.size(); }
+
+  auto begin() const noexcept { return values_.cbegin(); }
+  auto end() const noexcept { return values_.cend(); }
+
+  auto cbegin() const noexcept { return values_.cbegin(); }
+  auto cend() const noexcept { return values_.cend(); }
+
+private:
+  std::list<int> values_;
+};
+
+TEST_CASE("[vector] Operands without random access")
+{
+  using namespace vlite;
+
+  const auto a = list_vector{1, 2, 3};
+  const auto b = vector{10, 20, 30};
+
+  const auto c = a * 2 + b;
+  CHECK(all(c == vector{12, 24, 36}));
+  CHECK(all(vector(-a) == vector{-1, -2, -3}));
+  CHECK(sum(a + a) == 12);
+
+  // Both operator forms check the sizes of their operands.
+  CHECK_THROWS((a + vector{1, 2}));
+  CHECK_THROWS((b * vector{1, 2}));
+  CHECK_THROWS((apply(b, vector{1, 2}, std::plus<>{})));
+}
+
+TEST_CASE("[vector] Random access expressions")
+{
+  using namespace vlite;
+
+  const auto a = vector{1, 2, 3, 4, 5, 6};
+  const auto b = vector{6, 5, 4, 3, 2, 1};
+
+  const auto check = [](const auto& expr, auto expected) {
+    using traits = std::iterator_traits<typename std::decay_t<decltype(expr)>::iterator>;
+    static_assert(std::is_same_v<typename traits::iterator_category,
+                                 std::random_access_iterator_tag>);
+    static_assert(std::is_same_v<typename traits::reference, typename traits::value_type>);
+
+    CHECK(std::distance(expr.begin(), expr.end()) ==
+          static_cast<std::ptrdiff_t>(expected.size()));
+    CHECK(expr.end() - expr.begin() == static_cast<std::ptrdiff_t>(expected.size()));
+    CHECK(expr.begin() < expr.end());
+
+    for (std::size_t i = 0u; i < expected.size(); ++i)
+    {
+      CHECK(expr[i] == expected[i]);
+      CHECK(*(expr.begin() + i) == expected[i]);
+      CHECK(*(expr.end() - (expected.size() - i)) == expected[i]);
+    }
+  };
+
+  check(a * 2 + b, vector{8, 9, 10, 11, 12, 13});
+  check(a[{1, every, 2}] - b[{0, 3, 2}], vector{-4, -0, 4});
+  check(-a[{0, at_most(3), 2}], vector{-1, -3, -5});
+
+  const auto squares = a * a;
+  CHECK(all(vector<long>(squares.begin(), squares.end()) == vector{1, 4, 9, 16, 25, 36}));
+  CHECK(*std::lower_bound(squares.begin(), squares.end(), 16) == 16);
+  CHECK(std::lower_bound(squares.begin(), squares.end(), 17) - squares.begin() == 4);
+}
+
+TEST_CASE("[vector] Reductions")
+{
+  using namespace vlite;
+
+  const auto a = vector{3.0, -1.0, 4.0, 1.0, -5.0, 9.0, 2.0, 6.0, -5.0, 3.0, 5.0, 9.0,
+                        -2.0, 6.0, 5.0, 3.0, 5.0, 8.0, -9.0, 7.0, 9.0, 3.0, 2.0};
+  const auto b = vector<double>(2.0, a.size());
+
+  CHECK(sum(a) == 68.0);
+  CHECK(sum(a, pairwise) == 68.0);
+  CHECK(sum(a, compensated) == 68.0);
+  CHECK(sum(a * b) == 136.0);
+  CHECK(dot(a, b) == 136.0);
+  CHECK(sum(a[{1, every, 2}]) == 54.0);
+  CHECK(prod(a[{0, 4}]) == -12.0);
+  CHECK(prod(vector<int>(0u)) == 1);
+  CHECK(sum(vector{true, false, true}) == 2);
+
+  CHECK(min(a) == -9.0);
+  CHECK(max(a) == 9.0);
+  CHECK(argmin(a) == 18u);
+  CHECK(argmax(a) == 5u);
+  CHECK(argmax(-a) == 18u);
+  CHECK_THROWS(min(vector<double>(0u)));
+
+  CHECK(norm1(vector{3.0, -4.0}) == 7.0);
+  CHECK(norm(vector{3.0, -4.0}) == 5.0);
+  CHECK(norm_inf(vector{3.0, -4.0}) == 4.0);
+  CHECK(norm_inf(vector<unsigned>{3u, 4u}) == 4u);
+  CHECK(norm_inf(vector<double>(0u)) == 0.0);
+  CHECK_THROWS(dot(a, vector{1.0}));
+
+  // A sequential single-precision loop drops every small term added after the 1.
+  auto c = vector<float>(1e-8f, 1000001u);
+  c[0] = 1.0f;
+  CHECK(sum(c, compensated) == doctest::Approx(1.01f).epsilon(1e-6));
+  CHECK(sum(c, pairwise) == doctest::Approx(1.01f).epsilon(1e-4));
+}
+
+TEST_CASE("[vector] Logical reductions")
+{
+  using namespace vlite;
+
+  for (const auto size : {0u, 1u, 63u, 64u, 65u, 130u})
+  {
+    auto a = vector<int>(1, size);
+    CHECK(all(a == 1));
+    CHECK(none(a == 0));
+    CHECK(any(a == 1) == (size > 0u));
+    CHECK(count(a == 1) == size);
+
+    if (size == 0u)
+      continue;
+
+    a[size - 1u] = 0;
+    CHECK_FALSE(all(a == 1));
+    CHECK(any(a == 0));
+    CHECK_FALSE(none(a == 0));
+    CHECK(count(a == 1) == size - 1u);
+    CHECK(count(a[{0, every, 2}] != 0) == (size + 1u) / 2u - (size % 2u == 1u ? 1u : 0u));
+  }
+
+  // Evaluation stops at the first block that decides the result.
+  auto evaluated = 0u;
+  const auto a = vector<double>(1.0, 1000u);
+  const auto positive = [&](auto x) {
+    ++evaluated;
+    return x > 0.0;
+  };
+
+  CHECK(any(apply(a, positive)));
+  CHECK(evaluated == 64u);
+}
+
+TEST_CASE("[vector] Compound assignment")
+{
+  using namespace vlite;
+
+  auto a = vector<double>(1.0, 100u);
+  const auto b = vector<double>(2.0, 100u);
+  const auto data = a.data();
+
+  a += b;
+  CHECK(all(a == 3.0));
+  a *= b + 1.0;
+  CHECK(all(a == 9.0));
+  a -= 1.0;
+  CHECK(all(a == 8.0));
+  (a /= 2.0) /= b;
+  CHECK(all(a == 2.0));
+  a += a;
+  CHECK(all(a == 4.0));
+  CHECK(a.data() == data);
+
+  a[{0, 10}] += 1.0;
+  CHECK(all(a[{0, 10}] == 5.0));
+  CHECK(all(a[{10, every}] == 4.0));
+
+  a[{0, every, 2}] *= b[{0, 50}];
+  CHECK(all(a[{0, 5, 2}] == 10.0));
+  CHECK(all(a[{1, 5, 2}] == 5.0));
+  CHECK(all(a[{10, 45, 2}] == 8.0));
+
+  auto c = vector<int>{1, 2, 3};
+  c[{0, every, 2}] -= 1;
+  CHECK(all(c == vector{0, 2, 2}));
+  CHECK_THROWS(c += b);
+}
+
+TEST_CASE("[vector] Stored expressions")
+{
+  using namespace vlite;
+
+  const auto a = vector{1.0, 2.0, 3.0};
+  const auto b = vector{4.0, 5.0, 6.0};
+
+  // Subexpressions are held by value, so the expression outlives its statement.
+  const auto e = (a * b + 1.0) * (a - b) / 2.0;
+  const auto copy = e;
+  CHECK(all(vector(e) == vector{-7.5, -16.5, -28.5}));
+  CHECK(all(copy == e));
+
+  // Iterators are a node and an index, whatever the depth of the expression.
+  using iterator = decltype(e.begin());
+  static_assert(sizeof(iterator) == sizeof(void*) + sizeof(std::ptrdiff_t));
+  CHECK(e.end() - e.begin() == 3);
+  CHECK(e.begin() + 3 == e.end());
+  CHECK(*(e.begin() + 1) == -16.5);
+}
+
+TEST_CASE("[vector] Multiply-add fusion")
+{
+  using namespace vlite;
+
+  const auto a = vector{1.0, 2.0, 3.0};
+  const auto b = vector{4.0, 5.0, 6.0};
+
+  const auto scaled = a * 2.0 + b;
+  static_assert(std::is_base_of_v<expr_vector<detail::multiply_add>,
+                                  std::decay_t<decltype(scaled)>>);
+  CHECK(all(scaled == vector{6.0, 9.0, 12.0}));
+  CHECK(all(b + a * b == vector{8.0, 15.0, 24.0}));
+  CHECK(all(a * b + a * 2.0 == vector{6.0, 14.0, 24.0}));
+  CHECK(all(1.0 + 2.0 * a == vector{3.0, 5.0, 7.0}));
+  CHECK(all(vector{1, 2, 3} * 3 + vector{1, 1, 1} == vector{4, 7, 10}));
+
+  // Rvalue operands keep reusing their buffer.
+  auto c = vector{1.0, 1.0, 1.0};
+  const auto* buffer = &c[0];
+  const auto d = vector(std::move(c) + a * b);
+  CHECK(d.data() == buffer);
+  CHECK(all(d == vector{5.0, 11.0, 19.0}));
+}
+
+TEST_CASE("[cat_vector] Lazy concatenation")
+{
+  using namespace vlite;
+
+  const auto a = vector{1.0, 2.0, 3.0};
+  const auto b = vector{4, 5};
+
+  const auto c = cat_view(a, 0.5, b, a * 2.0);
+  static_assert(std::is_same_v<decltype(c)::value_type, double>);
+  CHECK(c.size() == 9u);
+  CHECK(c[3] == 0.5);
+  CHECK(c[5] == 5.0);
+  CHECK(sum(c) == 27.5);
+  CHECK(all(c * 2.0 == vector{2.0, 4.0, 6.0, 1.0, 8.0, 10.0, 4.0, 8.0, 12.0}));
+
+  const auto d = vector(c);
+  CHECK(all(d == vector{1.0, 2.0, 3.0, 0.5, 4.0, 5.0, 2.0, 4.0, 6.0}));
+
+  auto e = vector<double>(12u);
+  e[slice(0u, 9u)] = c;
+  e[slice(9u, 3u)] = cat_view(a[slice(1u, 2u)], 7.0);
+  CHECK(all(e[slice(0u, 9u)] == d));
+  CHECK(all(e[slice(9u, 3u)] == vector{2.0, 3.0, 7.0}));
+
+  // Rotations read every piece before writing any, including expression pieces.
+  auto g = vector{1.0, 2.0, 3.0, 4.0};
+  g[every] = cat_view(g[slice(2u, 2u)], g[slice(0u, 2u)]);
+  CHECK(all(g == vector{3.0, 4.0, 1.0, 2.0}));
+  g[slice(1u, 3u)] = cat_view(g[{0u, 2u, 2u}], 0.0);
+  CHECK(all(g == vector{3.0, 3.0, 1.0, 0.0}));
+  g[every] = cat_view(g[{1, every}] * 1.0, g[{0, 1}] * 1.0);
+  CHECK(all(g == vector{3.0, 1.0, 0.0, 3.0}));
+  g.assign(cat_view(-g[{2, every}], g[{0, 2}] + 0.0));
+  CHECK(all(g == vector{-0.0, -3.0, 3.0, 1.0}));
+
+  // `cat` returns a new vector, which owns its elements and can be modified.
+  auto h = cat(vector{1, 2}, 3);
+  static_assert(std::is_same_v<decltype(h), vector<int>>);
+  h[0] = 0;
+  CHECK(all(h == vector{0, 2, 3}));
+
+  const auto large = vector(1.0, detail::parallel_copy_bytes / sizeof(double));
+  const auto joined = cat(large, -1.0);
+  CHECK(joined.size() == large.size() + 1u);
+  CHECK(joined[large.size()] == -1.0);
+  CHECK(sum(joined) == large.size() - 1.0);
+
+  auto f = builder<double>(d.size() + 1u);
+  f.append(c);
+  f.push_back(-1.0);
+  CHECK(vector<double>(std::move(f))[8] == 6.0);
+}
+
+TEST_CASE("[vector] Masks and selection")
+{
+  using namespace vlite;
+
+  auto a = vector{3.0, -1.0, 4.0, -1.0, 5.0, -9.0, 2.0};
+  const auto& c = a;
+
+  const vector<double> positive = a[a > 0.0];
+  CHECK(all(positive == vector{3.0, 4.0, 5.0, 2.0}));
+  CHECK(c[c < 0.0].count() == 3u);
+  CHECK(compress(a * 2.0, a < -5.0)[0] == -18.0);
+  CHECK_THROWS((a[vector{true, false}]));
+
+  const auto clipped = where(a > 0.0, a, 0.0) * 2.0;
+  CHECK(all(clipped == vector{6.0, 0.0, 8.0, 0.0, 10.0, 0.0, 4.0}));
+
+  a[a < 0.0] = 0.0;
+  CHECK(all(a >= 0.0));
+  a[a == 0.0] = vector{1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0};
+  CHECK(all(a == vector{3.0, 2.0, 4.0, 4.0, 5.0, 6.0, 2.0}));
+
+  // Large inputs are compacted in parallel chunks.
+  const auto n = 3u * parallel_threshold + 17u;
+  auto b = vector<std::size_t>(uninitialized, n);
+  for (auto i = std::size_t{}; i < n; ++i)
+    b[i] = i;
+  const auto odd = compress(b, b % 2u == 1u);
+  CHECK(odd.size() == n / 2u);
+  CHECK(odd[0] == 1u);
+  CHECK(odd[odd.size() - 1u] == n - 2u);
+  CHECK(all(odd % 2u == 1u));
+
+  const auto words = vector<std::string>{"a", "b", "c"};
+  const vector<std::string> kept = words[vector{true, false, true}];
+  CHECK(kept.size() == 2u);
+  CHECK(kept[1] == "c");
+
+  // Elements that are not trivially copyable are compacted sequentially at any size.
+  const auto many = vector<std::string>(std::string{"x"}, n);
+  const auto thirds = compress(many, b % 3u == 0u);
+  CHECK(thirds.size() == (n + 2u) / 3u);
+  CHECK(thirds[thirds.size() - 1u] == "x");
+}
+
+TEST_CASE("[vector] Indirect access")
+{
+  using namespace vlite;
+
+  auto a = vector{10.0, 11.0, 12.0, 13.0, 14.0};
+  const auto& c = a;
+  const auto rows = vector<int>{4, 0, 2, 2};
+
+  const auto picked = vector(c[rows]);
+  CHECK(all(picked == vector{14.0, 10.0, 12.0, 12.0}));
+  CHECK(all(a[rows] * 2.0 == vector{28.0, 20.0, 24.0, 24.0}));
+  CHECK(sum(c[vector<std::size_t>{1u, 3u}]) == 24.0);
+  CHECK(c[rows + 1][3] == 13.0);
+
+  a[vector<std::size_t>{1u, 3u}] = vector{-1.0, -3.0};
+  a[rows] = 0.0;
+  CHECK(all(a == vector{0.0, -1.0, 0.0, -3.0, 0.0}));
+
+  auto b = vector<double>(4u);
+  b[slice(0u, 4u)] = c[vector<long>{3, 1, 3, 1}];
+  CHECK(all(b == vector{-3.0, -1.0, -3.0, -1.0}));
+  b[vector<int>{0, 1}] = b[vector<int>{2, 3}];
+
+  // Permutations in place read every element before writing any.
+  auto p = vector{1.0, 2.0, 3.0, 4.0};
+  const auto shift = vector<int>{1, 2, 3, 0};
+  p[shift] = p;
+  CHECK(all(p == vector{4.0, 1.0, 2.0, 3.0}));
+  p[every] = p[shift];
+  CHECK(all(p == vector{1.0, 2.0, 3.0, 4.0}));
+  p[slice(1u, 3u)] = p[vector<int>{0, 1, 2}];
+  CHECK(all(p == vector{1.0, 1.0, 2.0, 3.0}));
+  p[shift] = p * 10.0;
+  CHECK(all(p == vector{30.0, 10.0, 10.0, 20.0}));
+
+  // Large sources are gathered and scattered with prefetching.
+  const auto n = 2u * detail::indirect_prefetch_bytes / sizeof(float);
+  auto large = vector<float>(uninitialized, n);
+  for (auto i = std::size_t{}; i < n; ++i)
+    large[i] = static_cast<float>(i % 1000u);
+  auto indices = vector<std::int64_t>(uninitialized, 1001u);
+  for (auto i = std::size_t{}; i < indices.size(); ++i)
+    indices[i] = static_cast<std::int64_t>((i * 7919u) % n);
+  const auto gathered = vector(large[indices]);
+  for (auto i = std::size_t{}; i < indices.size(); ++i)
+    CHECK(gathered[i] == large[static_cast<std::size_t>(indices[i])]);
+  large[indices] = -1.0f;
+  CHECK(count(large == -1.0f) == indices.size());
+}
+
+TEST_CASE("[vector] Strided access")
+{
+  using namespace vlite;
+
+  // A 100 x 16 row-major matrix, so that columns have a stride of one cache line.
+  auto m = vector<float>(0.0f, 1600u);
+  for (auto i = 0u; i < m.size(); ++i)
+    m[i] = static_cast<float>(i);
+
+  auto column = m[{3u, every, 16u}];
+  CHECK(column.size() == 100u);
+
+  const auto first = column.begin(), last = column.end();
+  CHECK(last - first == 100);
+  CHECK(first < last);
+  CHECK(first + 100 == last);
+  CHECK(last[-1] == 1587.0f);
+  CHECK(std::lower_bound(first, last, 803.0f) - first == 50);
+
+  const auto copy = vector(column);
+  CHECK(all(copy == column));
+  CHECK(copy[99] == 1587.0f);
+
+  column = -column * 2.0f;
+  CHECK(m[3] == -6.0f);
+  CHECK(m[19] == -38.0f);
+
+  std::sort(column.begin(), column.end());
+  CHECK(column[0] == -3174.0f);
+  CHECK(m[4] == 4.0f);
+
+  column = 1.0f;
+  CHECK(sum(m[{3u, every, 16u}]) == 100.0f);
+  CHECK(m[1587] == 1.0f);
+  CHECK(m[1588] == 1588.0f);
+
+  m[{0u, every, 16u}] = m[{1u, every, 16u}];
+  CHECK(m[16] == 17.0f);
+
+  // Strided views are copied element to element, with small and large strides and
+  // across element types.
+  auto n = vector<float>(uninitialized, 1600u);
+  std::iota(n.begin(), n.end(), 0.0f);
+  auto d = vector<double>(0.0, 803u);
+  d[{1u, 401u, 2u}] = n[{5u, 401u, 3u}];
+  CHECK(d[0] == 0.0);
+  CHECK(d[1] == 5.0);
+  CHECK(d[801] == 1205.0);
+  n[{2u, 99u, 16u}] = d[{3u, 99u, 8u}];
+  CHECK(n[2] == 8.0f);
+  CHECK(n[2u + 98u * 16u] == 8.0f + 98u * 12u);
+  CHECK(n[3u + 98u * 16u] == 3.0f + 98u * 16u);
+}
+
+TEST_CASE("[vector] Buffer reuse")
+{
+  using namespace vlite;
+
+  auto a = vector{1.0, 2.0, 3.0};
+  const auto b = vector{1.0, 1.0, 1.0};
+
+  const auto* data = a.data();
+  a.assign(a * 2.0 + b);
+  CHECK(a.data() == data);
+  CHECK(all(a == vector{3.0, 5.0, 7.0}));
+
+  a.assign(vector{1.0, 2.0});
+  CHECK(a.size() == 2u);
+
+  auto c = vector{1.0, 2.0, 3.0};
+  data = c.data();
+  const auto d = vector(-(std::move(c) * 2.0 + b) / 2.0);
+  CHECK(d.data() == data);
+  CHECK(all(d == vector{-1.5, -2.5, -3.5}));
+
+  auto e = vector{1.0, 2.0, 3.0};
+  data = e.data();
+  const vector<double> f = 1.0 - b * std::move(e);
+  CHECK(f.data() == data);
+  CHECK(all(f == vector{0.0, -1.0, -2.0}));
+
+  // The chain is evaluated in a single pass when it is converted to a vector.
+  auto k = vector{1.0, 2.0, 3.0};
+  data = k.data();
+  auto lazy = std::move(k) * 2.0 + b;
+  CHECK(lazy[2] == 7.0);
+  CHECK(data[2] == 3.0);
+  CHECK(sum(lazy) == 15.0);
+  const auto l = vector(std::move(lazy));
+  CHECK(l.data() == data);
+  CHECK(all(l == vector{3.0, 5.0, 7.0}));
+
+  auto g = vector{1.0, 2.0, 3.0};
+  data = g.data();
+  const auto h = std::move(g) + vector{1.0, 1.0, 1.0};
+  CHECK(h.data() == data);
+
+  // Results of a different type are lazy expressions as usual.
+  auto i = vector{1, 2, 3};
+  const auto j = vector(std::move(i) * 0.5);
+  CHECK(all(j == vector{0.5, 1.0, 1.5}));
+  CHECK(i.size() == 3u);
+
+  CHECK_THROWS((vector{1.0, 2.0} + b));
+}
+
+TEST_CASE("[vector] Parallel evaluation")
+{
+  using namespace vlite;
+
+  const auto size = 100000u;
+  auto a = vector<double>(size);
+  auto b = vector<double>(size);
+  for (std::size_t i = 0u; i < size; ++i)
+  {
+    a[i] = static_cast<double>(i);
+    b[i] = 2.0;
+  }
+
+  const auto c = vector(parallel(a * b + 1.0, 0u));
+  CHECK(c.size() == size);
+  CHECK(all(c == 2.0 * a + 1.0));
+
+  auto d = vector<double>(size / 2u);
+  d[every] = parallel(a[{0u, size / 2u, 2u}] - 1.0, 0u);
+  CHECK(all(d == a[{0u, size / 2u, 2u}] - 1.0));
+
+  a[{1u, every, 2u}] = parallel(b[{0u, size / 2u}], 0u);
+  CHECK(all(a[{1u, every, 2u}] == 2.0));
+  CHECK_THROWS(d[every] = parallel(a * b));
+
+  // The wrapper owns the expression it was built from.
+  const auto stored = parallel(a * b + 1.0, 0u);
+  auto e = vector<double>(size);
+  e[every] = stored;
+  CHECK(all(e == a * b + 1.0));
+}
+
 #endif // DOCTEST_LIBRARY_INCLUDED
 
 #endif // VLITE_VECTOR_VECTOR_HPP_INCLUDED